@@ -0,0 +1,19 @@
+#include "blocked_memo.hpp"
+
+using namespace std;
+
+bool
+blocked_memo::is_blocked(const demand &d, const CU &cu,
+                         unsigned long epoch) const
+{
+  auto i = m_memo.find(key_type(d, cu));
+  return i != m_memo.end() && i->second == epoch;
+}
+
+void
+blocked_memo::blocked(const demand &d, const CU &cu, unsigned long epoch)
+{
+  // We don't erase the stale entries, because they are overwritten
+  // when the demand gets blocked again.
+  m_memo[key_type(d, cu)] = epoch;
+}
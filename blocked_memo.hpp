@@ -0,0 +1,34 @@
+#ifndef BLOCKED_MEMO_HPP
+#define BLOCKED_MEMO_HPP
+
+#include "graph.hpp"
+
+#include <map>
+#include <utility>
+
+// The memo of the blocked demands.  We remember the release epoch at
+// which a demand was blocked.  The demand stays blocked as long as no
+// units were released since then, because setting up a path only
+// takes units away, and so it cannot make a blocked demand feasible.
+// The epoch is given by the caller, so that the memos share the
+// epoch of the releases, e.g., routing::release_epoch.
+class blocked_memo
+{
+  // The key is the demand (the end nodes and the ncu), and the CU the
+  // search was given.
+  using key_type = std::pair<demand, CU>;
+
+  // The release epoch at which a demand was blocked.
+  std::map<key_type, unsigned long> m_memo;
+
+public:
+  // True if the demand is known to be blocked in the given epoch.
+  bool
+  is_blocked(const demand &d, const CU &cu, unsigned long epoch) const;
+
+  // Remember that the demand was blocked in the given epoch.
+  void
+  blocked(const demand &d, const CU &cu, unsigned long epoch);
+};
+
+#endif /* BLOCKED_MEMO_HPP */
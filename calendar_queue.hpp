@@ -0,0 +1,267 @@
+#ifndef CALENDAR_QUEUE_HPP
+#define CALENDAR_QUEUE_HPP
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+// =======================================================================
+// The calendar queue of the events:
+//
+// Randy Brown, Calendar queues: a fast O(1) priority queue
+// implementation for the simulation event set problem, Communications
+// of the ACM, vol. 31, no. 10, 1988, pages 1220-1227
+//
+// The time is divided into the days of the given width, and a year
+// has as many days as there are buckets.  An event goes to the bucket
+// of its day in any year.  The bucket is kept sorted by time, and a
+// new event goes after the events of the same time, and so the events
+// of the same time are dequeued in the order they were enqueued.  The
+// dequeue scans the buckets from the current day, and takes the first
+// event of the current year.  The number of buckets follows the
+// number of events, and the width follows the separation of the
+// events at the top of the queue.
+//
+// The interface is that of std::priority_queue with the earliest
+// event at the top.  TimeOf returns the time of an event.
+// =======================================================================
+
+template <typename T, typename TimeOf>
+class calendar_queue
+{
+  using bucket = std::vector<T>;
+
+  // The minimal number of buckets.
+  static constexpr std::size_t min_buckets = 2;
+
+  // The number of the events sampled for the width of a day.
+  static constexpr std::size_t samples = 25;
+
+  TimeOf m_to;
+
+  // The buckets.
+  std::vector<bucket> m_buckets;
+
+  // The width of a day.
+  double m_width;
+
+  // The number of events.
+  std::size_t m_size = 0;
+
+  // The current day counted from time 0, and not modulo the number
+  // of buckets, so that the end of the day doesn't drift.
+  mutable std::size_t m_day = 0;
+  mutable double m_end;
+
+  // The bucket of the top event, if known.
+  mutable std::size_t m_top;
+  mutable bool m_known = false;
+
+  // The day of time t.
+  std::size_t
+  day_of(double t) const
+  {
+    return std::size_t(std::floor(t / m_width));
+  }
+
+  // The bucket of time t.
+  std::size_t
+  bucket_of(double t) const
+  {
+    return day_of(t) % m_buckets.size();
+  }
+
+  // Make the given day the current day.
+  void
+  set_day(std::size_t day) const
+  {
+    m_day = day;
+    m_end = (day + 1) * m_width;
+  }
+
+  // Make the day of time t the current day.
+  void
+  start(double t) const
+  {
+    set_day(day_of(t));
+  }
+
+  // Insert the event into its bucket after the events of the same
+  // time.
+  template <typename U>
+  void
+  insert(U &&e)
+  {
+    double t = m_to(e);
+    bucket &b = m_buckets[bucket_of(t)];
+    auto i = std::upper_bound(b.begin(), b.end(), t,
+                              [this](double t, const T &e)
+                              {return t < m_to(e);});
+    b.insert(i, std::forward<U>(e));
+  }
+
+  // Find the bucket of the top event.
+  void
+  locate() const
+  {
+    assert(m_size);
+
+    if (m_known)
+      return;
+
+    // Scan a year from the current day.
+    for (std::size_t k = 0; k < m_buckets.size(); ++k)
+      {
+        std::size_t i = m_day % m_buckets.size();
+        const bucket &b = m_buckets[i];
+
+        if (!b.empty() && m_to(b.front()) < m_end)
+          {
+            m_top = i;
+            m_known = true;
+            return;
+          }
+
+        set_day(m_day + 1);
+      }
+
+    // There is no event in the year, so look for the earliest event.
+    const T *first = nullptr;
+    for (std::size_t i = 0; i < m_buckets.size(); ++i)
+      if (const bucket &b = m_buckets[i]; !b.empty())
+        if (!first || m_to(b.front()) < m_to(*first))
+          {
+            first = &b.front();
+            m_top = i;
+          }
+
+    start(m_to(*first));
+    m_known = true;
+  }
+
+  // Change the number of buckets to n, and compute the width anew.
+  void
+  resize(std::size_t n)
+  {
+    // The events in the order of the queue.  The events of the same
+    // time are in the same bucket, and the stable sort keeps their
+    // order.
+    std::vector<T> es;
+    es.reserve(m_size);
+    for (auto &b: m_buckets)
+      for (auto &e: b)
+        es.push_back(std::move(e));
+    std::stable_sort(es.begin(), es.end(),
+                     [this](const T &a, const T &b)
+                     {return m_to(a) < m_to(b);});
+
+    // The mean separation of the events sampled, without the
+    // separations much larger than the mean.
+    std::size_t ns = std::min(es.size(), samples);
+    if (ns > 1)
+      {
+        double mean = (m_to(es[ns - 1]) - m_to(es[0])) / (ns - 1);
+        double sum = 0;
+        std::size_t count = 0;
+        for (std::size_t i = 1; i < ns; ++i)
+          if (double s = m_to(es[i]) - m_to(es[i - 1]); s <= 2 * mean)
+            {
+              sum += s;
+              ++count;
+            }
+        if (sum > 0)
+          m_width = 3 * sum / count;
+      }
+
+    m_buckets.clear();
+    m_buckets.resize(n);
+    for (auto &e: es)
+      m_buckets[bucket_of(m_to(e))].push_back(std::move(e));
+
+    m_known = false;
+    if (!es.empty())
+      start(m_to(m_buckets[bucket_of(m_to(es.front()))].front()));
+  }
+
+public:
+  using value_type = T;
+  using size_type = std::size_t;
+  using reference = T &;
+  using const_reference = const T &;
+
+  explicit calendar_queue(double width = 1, TimeOf to = TimeOf()):
+    m_to(to), m_buckets(min_buckets), m_width(width), m_end(width)
+  {
+    assert(width > 0);
+  }
+
+  bool
+  empty() const
+  {
+    return !m_size;
+  }
+
+  size_type
+  size() const
+  {
+    return m_size;
+  }
+
+  // The earliest event.
+  const T &
+  top() const
+  {
+    locate();
+    return m_buckets[m_top].front();
+  }
+
+  void
+  push(const T &e)
+  {
+    emplace(e);
+  }
+
+  void
+  push(T &&e)
+  {
+    emplace(std::move(e));
+  }
+
+  template <typename... Args>
+  void
+  emplace(Args &&... args)
+  {
+    T e(std::forward<Args>(args)...);
+    double t = m_to(e);
+
+    // The event before the current day starts the scan anew.
+    if (!m_size || t < m_end - m_width)
+      start(t);
+
+    // The known top stays the top, unless the event is earlier.
+    if (m_known && t < m_to(m_buckets[m_top].front()))
+      m_known = false;
+
+    insert(std::move(e));
+
+    if (++m_size > 2 * m_buckets.size())
+      resize(2 * m_buckets.size());
+  }
+
+  void
+  pop()
+  {
+    locate();
+    bucket &b = m_buckets[m_top];
+    b.erase(b.begin());
+    m_known = false;
+
+    if (--m_size < m_buckets.size() / 2 &&
+        m_buckets.size() / 2 >= min_buckets)
+      resize(m_buckets.size() / 2);
+  }
+};
+
+#endif // CALENDAR_QUEUE_HPP
@@ -7,18 +7,42 @@
 #include <iostream>
 #include <map>
 #include <sstream>
+#include <stdexcept>
 #include <string>
 
 #include <boost/program_options.hpp>
 
 // Option strings.
 #define K_S "K"
+#define C2F_S "c2f"
 #define NET_S "net"
 #define ST_S "st"
 #define POPULATION_S "population"
+#define NOM_S "nom"
 #define PARALLEL_S "parallel"
 #define BRTFORCE_S "brtforce"
 #define PUYENKSP_S "puyenksp"
+#define AUTO_S "auto"
+#define EXPLORE_S "explore"
+#define AUTO_LOG_S "auto-log"
+#define MEMO_S "memo"
+#define MEMO_CHECK_S "memo-check"
+#define VERIFY_S "verify"
+#define XCHECK_THREADS_S "xcheck-threads"
+#define PARALLEL_THREADS_S "parallel-threads"
+#define BNB_S "bnb"
+#define SLOT_EDGES_S "slot-edges"
+#define OCCUPANCY_S "occupancy"
+#define FRAGMENT_CACHE_S "fragment-cache"
+#define VERSIONS_S "versions"
+#define RESERVATIONS_S "reservations"
+#define KSP_LIB_S "ksp-lib"
+#define KSP_LIB_FILE_S "ksp-lib-file"
+#define YEN_THREADS_S "yen-threads"
+#define YEN_TREE_S "yen-tree"
+#define YEN_SU_S "yen-su"
+#define EPPSTEIN_S "eppstein"
+#define VERIFY_THREADS_S "verify-threads"
 
 using namespace std;
 namespace po = boost::program_options;
@@ -47,12 +71,73 @@ process_cli_args(int argc, const char *argv[])
         (K_S, po::value<int>(),
          "the K for the k-shortest paths")
 
+        (KSP_LIB_S, "use the library of the K shortest paths")
+
+        (KSP_LIB_FILE_S, po::value<string>(),
+         "the file of the library of the K shortest paths")
+
         (ST_S, po::value<string>()->required(),
-         "the spectrum selection type")
+         "the spectrum selection type: first, fittest, or random")
+
+        (C2F_S, po::value<int>(),
+         "the number of units in a super unit of the coarse-to-fine search")
 
         (PARALLEL_S, "run the parallel search")
+
+        (PARALLEL_THREADS_S, po::value<unsigned>()->default_value(1),
+         "the number of threads of the parallel search")
+
+        (BNB_S, "search the slots of the parallel search by branch and bound")
+
+        (SLOT_EDGES_S, "maintain the sets of the edges with the slots")
+
+        (OCCUPANCY_S, "maintain the occupancy matrix of the units of the "
+         "edges; only then the units of the paths of the c2f and the "
+         "puyenksp searches are selected with the matrix in place of "
+         "find_path_su")
+
+        (FRAGMENT_CACHE_S, "maintain the cache of the fragment indexes of "
+         "the paths")
+
+        (VERSIONS_S, "maintain the versions of the units of the edges")
+
+        (RESERVATIONS_S, "maintain the reservation store of the units of "
+         "the edges")
+
         (BRTFORCE_S, "run the brtforce search")
-        (PUYENKSP_S, "run the puyenksp search");
+        (PUYENKSP_S, "run the puyenksp search")
+
+        (YEN_THREADS_S, po::value<unsigned>()->default_value(1),
+         "the number of threads of the spur paths of the puyenksp search")
+
+        (YEN_TREE_S, "complete the spur paths with the reverse shortest "
+         "path tree")
+
+        (YEN_SU_S, "prune the spur paths with the spectrum of the root "
+         "paths")
+
+        (EPPSTEIN_S, "use the Eppstein algorithm in place of the Yen "
+         "algorithm in the puyenksp search")
+
+        (XCHECK_THREADS_S, po::value<unsigned>()->default_value(0),
+         "the number of threads that run the other searches")
+
+        (AUTO_S, "select the routing algorithm online")
+
+        (EXPLORE_S, po::value<unsigned>()->default_value(20),
+         "every how many selections of the auto mode explore")
+
+        (AUTO_LOG_S, "log the selections of the auto mode")
+
+        (MEMO_S, "use the memo of the blocked demands")
+
+        (MEMO_CHECK_S, "validate every memo hit with the search")
+
+        (VERIFY_S, po::value<double>()->default_value(0),
+         "the fraction of searches checked in the background")
+
+        (VERIFY_THREADS_S, po::value<unsigned>()->default_value(1),
+         "the number of threads of the background checks");
 
       // Traffic options.
       po::options_description tra("Traffic options");
@@ -73,7 +158,10 @@ process_cli_args(int argc, const char *argv[])
          "the seed of the random number generator")
 
         (POPULATION_S, po::value<string>()->required(),
-         "the population name");
+         "the population name")
+
+        (NOM_S, po::value<int>()->default_value(100),
+         "the number of measurements of the network state");
 
       po::options_description all("Allowed options");
       all.add(gen).add(net).add(tra).add(sim);
@@ -99,17 +187,83 @@ process_cli_args(int argc, const char *argv[])
       if (vm.count(K_S))
         result.K = vm[K_S].as<int>();
 
+      // The library of the file implies using it.
+      if (vm.count(KSP_LIB_FILE_S))
+        result.ksp_lib_file = vm[KSP_LIB_FILE_S].as<string>();
+
+      if (vm.count(KSP_LIB_S) || result.ksp_lib_file)
+        {
+          if (!result.K)
+            throw std::invalid_argument("the library of the K shortest "
+                                        "paths requires the K");
+          result.ksp_lib = true;
+        }
+
       result.st = vm[ST_S].as<string>();
 
+      if (vm.count(C2F_S))
+        result.c2f = vm[C2F_S].as<int>();
+
       if (vm.count(PARALLEL_S))
         result.parallel = true;
 
+      result.parallel_threads = vm[PARALLEL_THREADS_S].as<unsigned>();
+
+      if (vm.count(BNB_S))
+        result.bnb = true;
+
+      if (vm.count(SLOT_EDGES_S))
+        result.slot_edges = true;
+
+      if (vm.count(OCCUPANCY_S))
+        result.occupancy = true;
+
+      if (vm.count(FRAGMENT_CACHE_S))
+        result.fragment_cache = true;
+
+      if (vm.count(VERSIONS_S))
+        result.versions = true;
+
+      if (vm.count(RESERVATIONS_S))
+        result.reservations = true;
+
       if (vm.count(BRTFORCE_S))
         result.brtforce = true;
 
       if (vm.count(PUYENKSP_S))
         result.puyenksp = true;
 
+      result.yen_threads = vm[YEN_THREADS_S].as<unsigned>();
+
+      if (vm.count(YEN_TREE_S))
+        result.yen_tree = true;
+
+      if (vm.count(YEN_SU_S))
+        result.yen_su = true;
+
+      if (vm.count(EPPSTEIN_S))
+        result.eppstein = true;
+
+      result.xcheck_threads = vm[XCHECK_THREADS_S].as<unsigned>();
+
+      if (vm.count(AUTO_S))
+        result.autom = true;
+
+      result.explore = vm[EXPLORE_S].as<unsigned>();
+
+      if (vm.count(AUTO_LOG_S))
+        result.auto_log = true;
+
+      if (vm.count(MEMO_S))
+        result.memo = true;
+
+      // Checking the memo implies using it.
+      if (vm.count(MEMO_CHECK_S))
+        result.memo = result.memo_check = true;
+
+      result.verify = vm[VERIFY_S].as<double>();
+      result.verify_threads = vm[VERIFY_THREADS_S].as<unsigned>();
+
       // The traffic options.
       result.ol = vm["ol"].as<double>();
       result.mht = vm["mht"].as<double>();
@@ -118,6 +272,7 @@ process_cli_args(int argc, const char *argv[])
       // The simulation options.
       result.seed = vm["seed"].as<int>();
       result.population = vm[POPULATION_S].as<string>();
+      result.nom = vm[NOM_S].as<int>();
     }
   catch(const std::exception& e)
     {
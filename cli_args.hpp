@@ -26,18 +26,85 @@ struct cli_args
   /// The K for the k-shortest paths.
   std::optional<unsigned> K;
 
+  /// Use the library of the K shortest paths.
+  bool ksp_lib = false;
+
+  /// The file of the library of the K shortest paths.
+  std::optional<std::string> ksp_lib_file;
+
   /// The spectrum selection type.
   std::string st;
 
+  /// The number of units in a super unit of the coarse-to-fine search.
+  std::optional<int> c2f;
+
   /// Use the parallel search.
   bool parallel = false;
 
+  // The number of threads of the parallel search.
+  unsigned parallel_threads;
+
+  // Search the slots of the parallel search by branch and bound.
+  bool bnb = false;
+
+  // Maintain the sets of the edges with the slots.
+  bool slot_edges = false;
+
+  // Maintain the occupancy matrix of the units of the edges.
+  bool occupancy = false;
+
+  // Maintain the cache of the fragment indexes of the paths.
+  bool fragment_cache = false;
+
+  // Maintain the versions of the SUs of the edges.
+  bool versions = false;
+
+  // Maintain the reservation store of the units of the edges.
+  bool reservations = false;
+
   // Use the brute force search.
   bool brtforce = false;
 
   // Use the puyenksp search.
   bool puyenksp = false;
 
+  // The number of threads of the spur paths of the puyenksp search.
+  unsigned yen_threads;
+
+  // Complete the spur paths with the reverse shortest path tree.
+  bool yen_tree = false;
+
+  // Prune the spur paths with the spectrum of the root paths.
+  bool yen_su = false;
+
+  // Use the Eppstein algorithm in the puyenksp search.
+  bool eppstein = false;
+
+  // The number of threads that run the other searches.  With 0, they
+  // run in the simulation thread.
+  unsigned xcheck_threads;
+
+  // Select the routing algorithm online.
+  bool autom = false;
+
+  // Every how many selections of the auto mode explore.
+  unsigned explore;
+
+  // Log the selections of the auto mode.
+  bool auto_log = false;
+
+  // Use the memo of the blocked demands.
+  bool memo = false;
+
+  // Validate every hit of the memo of the blocked demands.
+  bool memo_check = false;
+
+  // The fraction of searches checked in the background.
+  double verify;
+
+  // The number of threads of the background checks.
+  unsigned verify_threads;
+
   /// -----------------------------------------------------------------
   /// The traffic options
   /// -----------------------------------------------------------------
@@ -64,6 +131,9 @@ struct cli_args
   /// The population name.
   std::string population;
 
+  /// The number of instantaneous measurements of the network state.
+  int nom;
+
   /// The kickoff time for stats.
   double kickoff;
 
@@ -66,11 +66,18 @@ client::get_connection() const
   return conn;
 }
 
+connection &
+client::get_connection()
+{
+  return conn;
+}
+
 void
 client::destroy()
 {
   assert(conn.is_established());
-  conn.tear_down();
+  // The traffic needs the connection established to erase the client.
   tra.erase(this);
+  conn.tear_down();
   tra.delete_me_later(this);
 }
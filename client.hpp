@@ -51,6 +51,9 @@ public:
   const connection &
   get_connection() const;
 
+  connection &
+  get_connection();
+
 private:
   bool set_up();
   void destroy();
@@ -0,0 +1,79 @@
+#include "coarse_graph.hpp"
+#include "utils.hpp"
+
+#include <cassert>
+
+using namespace std;
+
+CU
+coarsen(const CU &cu, int k)
+{
+  unsigned min = cu.min() / k + (cu.min() % k != 0);
+  unsigned max = cu.max() / k;
+  return min < max ? CU(min, max) : CU();
+}
+
+SU
+coarsen(const SU &su, int k)
+{
+  SU result;
+
+  for (const auto &cu: su)
+    if (CU ccu = coarsen(cu, k))
+      result.insert(ccu);
+
+  return result;
+}
+
+coarse_graph::coarse_graph(graph &g, int k):
+  m_gp(&g), m_k(k), m_edges(index_edges(g))
+{
+  assert(k > 1);
+
+  // The copy keeps the edge indexes.
+  m_cg = g;
+  m_cedges.resize(m_edges.size());
+
+  for (auto ei = edges(m_cg).first; ei != edges(m_cg).second; ++ei)
+    {
+      auto i = boost::get(boost::edge_index, m_cg, *ei);
+      m_cedges[i] = *ei;
+      boost::get(boost::edge_su, m_cg, *ei) =
+        coarsen(boost::get(boost::edge_su, g, m_edges[i]), k);
+    }
+}
+
+bool
+coarse_graph::is_of(const graph &g) const
+{
+  return m_gp == &g;
+}
+
+int
+coarse_graph::k() const
+{
+  return m_k;
+}
+
+const graph &
+coarse_graph::get() const
+{
+  return m_cg;
+}
+
+const edge &
+coarse_graph::fine(const edge &ce) const
+{
+  return m_edges[boost::get(boost::edge_index, m_cg, ce)];
+}
+
+void
+coarse_graph::update(const path &p)
+{
+  for(const auto &e: p)
+    {
+      auto i = boost::get(boost::edge_index, *m_gp, e);
+      boost::get(boost::edge_su, m_cg, m_cedges[i]) =
+        coarsen(boost::get(boost::edge_su, *m_gp, e), m_k);
+    }
+}
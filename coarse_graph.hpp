@@ -0,0 +1,67 @@
+#ifndef COARSE_GRAPH_HPP
+#define COARSE_GRAPH_HPP
+
+#include "graph.hpp"
+
+#include <vector>
+
+// Return the CU of super units, each of k units, that are included in
+// the given CU.  The CU returned can be empty.
+CU
+coarsen(const CU &cu, int k);
+
+// Return the SU of super units, each of k units, that are included in
+// the given SU.
+SU
+coarsen(const SU &su, int k);
+
+// The coarse graph of the coarse-to-fine search.  It's the copy of a
+// graph, but the SU of an edge has super units, each of k units, and
+// a super unit is available only if all its units are available.  The
+// edges of both graphs are indexed with the edge_index property, and
+// an edge of the coarse graph has the index of its original edge.
+// The SUs of the edges are coarsened anew as the units of the
+// original edges are taken and released.
+class coarse_graph
+{
+  // The original graph.
+  const graph *m_gp;
+
+  // The number of units in a super unit.
+  int m_k;
+
+  // The coarse graph.
+  graph m_cg;
+
+  // The edges of the original and the coarse graphs indexed with the
+  // edge_index property.
+  std::vector<edge> m_edges;
+  std::vector<edge> m_cedges;
+
+public:
+  // The edges of the graph are indexed with the edge_index property.
+  coarse_graph(graph &g, int k);
+
+  // True if this is the coarse graph of graph g.
+  bool
+  is_of(const graph &g) const;
+
+  // The number of units in a super unit.
+  int
+  k() const;
+
+  // The coarse graph.
+  const graph &
+  get() const;
+
+  // The original edge of the edge of the coarse graph.
+  const edge &
+  fine(const edge &ce) const;
+
+  // Coarsen the SUs of the edges of path p anew, after their units
+  // were taken or released.
+  void
+  update(const path &p);
+};
+
+#endif // COARSE_GRAPH_HPP
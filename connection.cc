@@ -77,3 +77,12 @@ connection::tear_down()
   routing::tear_down(m_g, m_p.value());
   m_p.reset();
 }
+
+cupath
+connection::detach()
+{
+  assert(is_established());
+  cupath result = std::move(m_p.value());
+  m_p.reset();
+  return result;
+}
@@ -44,6 +44,11 @@ public:
   void
   tear_down();
 
+  // Forget the path of the established connection without tearing it
+  // down, and return it, so that it can be torn down in a batch.
+  cupath
+  detach();
+
 private:
   graph &m_g;
   demand m_d;
@@ -10,19 +10,28 @@
 // =======================================================================
 // The custom Dijkstra call, which returns the optional path as a list
 // of edges along with the cost of the path.  The search is stopped
-// when the destination node is reached.
+// when the destination node is reached.  The call runs the BGL
+// Dijkstra, and the workspace makes the steps of the BGL Dijkstra
+// without allocating the maps and without throwing an exception, and
+// so it finds the same path.
 // =======================================================================
 
 #ifndef BOOST_GRAPH_CUSTOM_DIJKSTRA_CALL
 #define BOOST_GRAPH_CUSTOM_DIJKSTRA_CALL
 
+#include <boost/graph/detail/d_ary_heap.hpp>
 #include <boost/graph/dijkstra_shortest_paths.hpp>
+#include <boost/graph/graph_traits.hpp>
 #include <boost/graph/visitors.hpp>
 #include <boost/property_map/property_map.hpp>
 
+#include <algorithm>
+#include <functional>
 #include <list>
 #include <map>
 #include <optional>
+#include <utility>
+#include <vector>
 
 namespace boost {
 
@@ -120,6 +129,153 @@ namespace boost {
     catch (exception) {}
   }
 
+  // =======================================================================
+  // The workspace of the Dijkstra search, which is reused by the
+  // searches, so that the maps are not allocated for every search.
+  // The predecessor, the distance, the colour, and the heap index
+  // maps are vectors.  The entries of a vector are valid only if
+  // their generation stamp is the generation of the current search,
+  // and so the vectors are not cleared between the searches.  The
+  // search stops when it reaches the destination without throwing an
+  // exception.
+  //
+  // The search makes the steps of the BGL Dijkstra: the vertexes are
+  // queued in the same 4-ary heap, and the edges are relaxed in the
+  // same order, and so the ties of the costs are broken the same way.
+  // =======================================================================
+
+  template <typename Graph, typename Weight>
+  class dijkstra_workspace
+  {
+    typedef typename Graph::vertex_descriptor vertex_descriptor;
+    typedef typename Graph::edge_descriptor edge_descriptor;
+
+    // The predecessor edges.
+    std::vector<edge_descriptor> m_pred;
+    // The distances.
+    std::vector<Weight> m_dist;
+    // The colours: true if the vertex is finished.
+    std::vector<char> m_black;
+    // The generation stamps of the entries.
+    std::vector<unsigned> m_stamp;
+    // The indexes of the vertexes in the heap.
+    std::vector<std::size_t> m_index;
+    // The generation of the current search.
+    unsigned m_gen = 0;
+
+  public:
+    dijkstra_workspace(std::size_t n = 0)
+    {
+      resize(n);
+    }
+
+    void
+    resize(std::size_t n)
+    {
+      if (m_stamp.size() < n)
+        {
+          m_pred.resize(n);
+          m_dist.resize(n);
+          m_black.resize(n);
+          m_index.resize(n);
+          m_stamp.resize(n, 0);
+        }
+    }
+
+    // Search for the shortest path from src to dst in graph g, which
+    // can be a filtered graph of Graph.
+    template <typename G, typename WeightMap, typename IndexMap>
+    std::optional<std::pair<Weight, std::list<edge_descriptor>>>
+    operator()(const G &g, vertex_descriptor src, vertex_descriptor dst,
+               WeightMap wm, IndexMap im)
+    {
+      typedef std::pair<Weight, std::list<edge_descriptor>> r_type;
+
+      if (src == dst)
+        return r_type();
+
+      resize(num_vertices(g));
+
+      // Start the new generation.  If the stamps wrapped around, the
+      // old stamps are cleared.
+      if (++m_gen == 0)
+        {
+          std::fill(m_stamp.begin(), m_stamp.end(), 0);
+          m_gen = 1;
+        }
+
+      // The queue of the BGL Dijkstra.
+      auto dm = make_iterator_property_map(m_dist.begin(), im);
+      auto hm = make_iterator_property_map(m_index.begin(), im);
+      d_ary_heap_indirect<vertex_descriptor, 4, decltype(hm), decltype(dm),
+                          std::less<Weight>> Q(dm, hm);
+
+      auto si = get(im, src);
+      m_stamp[si] = m_gen;
+      m_dist[si] = Weight();
+      m_black[si] = false;
+      Q.push(src);
+
+      bool found = false;
+
+      while (!Q.empty())
+        {
+          vertex_descriptor u = Q.top();
+          Q.pop();
+
+          // The early exit.
+          if (u == dst)
+            {
+              found = true;
+              break;
+            }
+
+          auto ui = get(im, u);
+
+          for (const auto &e: make_iterator_range(out_edges(u, g)))
+            {
+              vertex_descriptor v = target(e, g);
+              auto vi = get(im, v);
+              Weight nd = m_dist[ui] + get(wm, e);
+
+              if (m_stamp[vi] != m_gen)
+                {
+                  // The vertex is discovered.
+                  m_stamp[vi] = m_gen;
+                  m_black[vi] = false;
+                  m_dist[vi] = nd;
+                  m_pred[vi] = e;
+                  Q.push(v);
+                }
+              else if (!m_black[vi] && nd < m_dist[vi])
+                {
+                  // The vertex in the queue is relaxed.
+                  m_dist[vi] = nd;
+                  m_pred[vi] = e;
+                  Q.update(v);
+                }
+            }
+
+          m_black[ui] = true;
+        }
+
+      if (!found)
+        return std::nullopt;
+
+      // Trace the solution to the source.
+      r_type r;
+      for (vertex_descriptor c = dst; c != src;)
+        {
+          const edge_descriptor &e = m_pred[get(im, c)];
+          r.first += get(wm, e);
+          r.second.push_front(e);
+          c = source(e, g);
+        }
+
+      return r;
+    }
+  };
+
   // =======================================================================
   // The function that calls Dijkstra.  The function returns a list of
   // edges of the shortest path.
@@ -0,0 +1,31 @@
+#include "distance_cache.hpp"
+
+#include <boost/graph/dijkstra_shortest_paths.hpp>
+
+using namespace std;
+
+distance_cache::distance_cache(const graph &g): m_gp(&g)
+{
+}
+
+bool
+distance_cache::is_of(const graph &g) const
+{
+  return m_gp == &g;
+}
+
+const vector<COST> &
+distance_cache::from(vertex v)
+{
+  auto i = m_dists.find(v);
+
+  if (i == m_dists.end())
+    {
+      vector<COST> dist(num_vertices(*m_gp));
+      boost::dijkstra_shortest_paths(*m_gp, v,
+                                     boost::distance_map(&dist[0]));
+      i = m_dists.insert(make_pair(v, std::move(dist))).first;
+    }
+
+  return i->second;
+}
@@ -0,0 +1,37 @@
+#ifndef DISTANCE_CACHE_HPP
+#define DISTANCE_CACHE_HPP
+
+#include "graph.hpp"
+
+#include <map>
+#include <vector>
+
+// The cache of the shortest distances between the vertices of a graph
+// regardless of the units available.  The distances are the lower
+// bounds on the lengths of the paths found by any routing algorithm.
+// The distances from a vertex are computed the first time they are
+// asked for.  The graph is undirected, so the distances from a vertex
+// are also the distances to it.  The weights of the edges of the
+// graph have to stay the same, and the cache has to be made anew for
+// another graph.
+class distance_cache
+{
+  // The graph.
+  const graph *m_gp;
+
+  // The distances from the vertices.
+  std::map<vertex, std::vector<COST>> m_dists;
+
+public:
+  explicit distance_cache(const graph &g);
+
+  // True if this is the cache of graph g.
+  bool
+  is_of(const graph &g) const;
+
+  // The distances from vertex v.
+  const std::vector<COST> &
+  from(vertex v);
+};
+
+#endif // DISTANCE_CACHE_HPP
@@ -0,0 +1,55 @@
+#include "edge_counters.hpp"
+
+#include <boost/range.hpp>
+
+edge_counters::edge_counters(const graph &g):
+  m_gp(&g), m_edges(num_edges(g))
+{
+  for(const auto &e: boost::make_iterator_range(edges(g)))
+    add(e);
+}
+
+bool
+edge_counters::is_of(const graph &g) const
+{
+  return m_gp == &g;
+}
+
+void
+edge_counters::remove(const edge &e)
+{
+  // Total available units.
+  int tsc = boost::get(boost::edge_nou, *m_gp, e);
+  const SU &su = boost::get(boost::edge_su, *m_gp, e);
+
+  m_used[tsc] -= tsc - int(su.count());
+  m_frags -= su.size();
+}
+
+void
+edge_counters::add(const edge &e)
+{
+  // Total available units.
+  int tsc = boost::get(boost::edge_nou, *m_gp, e);
+  const SU &su = boost::get(boost::edge_su, *m_gp, e);
+
+  m_used[tsc] += tsc - int(su.count());
+  m_frags += su.size();
+}
+
+double
+edge_counters::utilization() const
+{
+  double sum = 0;
+
+  for (const auto &[nou, used]: m_used)
+    sum += double(used) / nou;
+
+  return m_edges ? sum / m_edges : 0;
+}
+
+double
+edge_counters::fragments() const
+{
+  return m_edges ? double(m_frags) / m_edges : 0;
+}
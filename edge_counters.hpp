@@ -0,0 +1,53 @@
+#ifndef EDGE_COUNTERS_HPP
+#define EDGE_COUNTERS_HPP
+
+#include "graph.hpp"
+
+#include <map>
+
+// The counters of the units used and of the fragments of the edges.
+// They are updated as the SU of an edge changes: the edge is removed
+// before the change, and added after it.  Then the utilization and
+// the mean number of fragments of the network are known without
+// scanning the edges.
+class edge_counters
+{
+  // The graph.
+  const graph *m_gp;
+
+  // The number of edges.
+  std::size_t m_edges;
+
+  // The sums over the edges of the numbers of the units used, per
+  // number of units of an edge.  The sums are integers, so that they
+  // don't drift, and they are divided in utilization() only.
+  std::map<unsigned, long> m_used;
+
+  // The sum over the edges of the number of fragments.
+  long m_frags = 0;
+
+public:
+  explicit edge_counters(const graph &g);
+
+  // True if these are the counters of graph g.
+  bool
+  is_of(const graph &g) const;
+
+  // Remove the edge from the counters before its SU changes.
+  void
+  remove(const edge &e);
+
+  // Add the edge to the counters after its SU changed.
+  void
+  add(const edge &e);
+
+  // The mean utilization of the edges.
+  double
+  utilization() const;
+
+  // The mean number of fragments of the edges.
+  double
+  fragments() const;
+};
+
+#endif // EDGE_COUNTERS_HPP
@@ -0,0 +1,30 @@
+#ifndef EDGE_HAS_UNITS_HPP
+#define EDGE_HAS_UNITS_HPP
+
+#include "graph.hpp"
+
+// The edge predicate of a filtered graph: true if the edge has the
+// given units available.
+template <typename Units>
+struct edge_has_units
+{
+  const graph *m_gp;
+  const Units *m_units;
+
+  edge_has_units(): m_gp(0), m_units(0)
+  {
+  }
+
+  edge_has_units(const graph &g, const Units &units):
+    m_gp(&g), m_units(&units)
+  {
+  }
+
+  bool
+  operator () (const edge &e) const
+  {
+    return boost::get(boost::edge_su, *m_gp, e).includes(*m_units);
+  }
+};
+
+#endif // EDGE_HAS_UNITS_HPP
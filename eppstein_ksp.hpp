@@ -0,0 +1,324 @@
+// =======================================================================
+// This is the implementation of the lazy Eppstein algorithm:
+//
+// David Eppstein, Finding the k shortest paths, SIAM Journal on
+// Computing, vol. 28, no. 2, 1998, pages 652-673
+//
+// Víctor M. Jiménez, Andrés Marzal, A lazy version of Eppstein's K
+// shortest paths algorithm, WEA 2003, LNCS 2647, pages 179-191
+//
+// A path is represented by the sequence of its sidetracks, i.e., the
+// edges that are not in the shortest path tree rooted at t.  The
+// delta of a sidetrack is the extra cost of taking it instead of
+// following the tree.  The sidetracks of the vertexes along the tree
+// path from v to t are kept sorted by delta in the list of v, which
+// is computed lazily from the list of the next vertex.  In place of
+// the persistent heaps of Eppstein, we keep the sorted lists, and so
+// a path has at most two children: the path with the next sidetrack
+// of the same list, and the path extended with the first sidetrack
+// of the list of the head of the last sidetrack.
+//
+// The paths can have loops, and so the loopless filter skips them.
+// There are infinitely many paths with loops, but a loopless path is
+// not longer than the sum of the weights of all edges, and so the
+// enumeration stops there.
+// =======================================================================
+
+#ifndef BOOST_GRAPH_EPPSTEIN_KSP
+#define BOOST_GRAPH_EPPSTEIN_KSP
+
+#include <algorithm>
+#include <cassert>
+#include <functional>
+#include <list>
+#include <optional>
+#include <queue>
+#include <utility>
+#include <vector>
+
+#include "yen_ksp.hpp"
+
+namespace boost {
+
+  template <typename Graph, typename WeightMap, typename IndexMap>
+  class eppstein_ksp
+  {
+    using weight_type = typename WeightMap::value_type;
+    using kr_type = Result<weight_type, Graph>;
+
+    // The sidetrack edge with its delta.
+    using sidetrack = std::pair<weight_type, Edge<Graph>>;
+
+    // A node of the tree of the paths.
+    struct node
+    {
+      // The parent node.
+      std::size_t m_parent;
+      // The vertex of the list of the sidetrack.
+      Vertex<Graph> m_head;
+      // The rank of the sidetrack in the list.
+      std::size_t m_rank;
+      // The cost of the path.
+      weight_type m_cost;
+    };
+
+    // The marker of no parent and no sidetrack of the root node.
+    static constexpr std::size_t npos = -1;
+
+    const Graph &m_g;
+    WeightMap m_wm;
+    IndexMap m_im;
+
+    // The source and the target.
+    Vertex<Graph> m_s;
+    Vertex<Graph> m_t;
+
+    // The distances to t.
+    std::vector<weight_type> m_dist;
+
+    // The next edge towards t, oriented from the vertex.
+    std::vector<std::optional<Edge<Graph>>> m_next;
+
+    // The lists of the sidetracks, computed lazily.
+    std::vector<std::optional<std::vector<sidetrack>>> m_lists;
+
+    // The nodes of the tree of the paths.
+    std::vector<node> m_nodes;
+
+    // The queue of the nodes not processed yet: the costs of the
+    // paths and the node numbers.
+    using qe_type = std::pair<weight_type, std::size_t>;
+    std::priority_queue<qe_type, std::vector<qe_type>,
+                        std::greater<qe_type>> m_q;
+
+    // The upper bound on the cost of a loopless path.
+    weight_type m_ub = 0;
+
+    // The stamps of the vertexes visited by the path traced.
+    std::vector<std::size_t> m_visited;
+    std::size_t m_stamp = 0;
+
+  public:
+    // The number of the paths with loops skipped.
+    std::size_t m_loops = 0;
+
+    eppstein_ksp(const Graph &g, Vertex<Graph> s, Vertex<Graph> t,
+                 WeightMap wm, IndexMap im):
+      m_g(g), m_wm(wm), m_im(im), m_s(s), m_t(t),
+      m_dist(num_vertices(g)), m_next(num_vertices(g)),
+      m_lists(num_vertices(g)), m_visited(num_vertices(g))
+    {
+      assert(s != t);
+
+      reverse_tree(g, t, wm, im, m_dist, m_next);
+
+      for (auto e: make_iterator_range(edges(g)))
+        m_ub += get(wm, e);
+
+      // The shortest path, if there is one, is the root of the tree.
+      if (m_next[get(m_im, s)])
+        {
+          m_nodes.push_back({npos, s, npos, m_dist[get(m_im, s)]});
+          m_q.push({m_nodes.back().m_cost, 0});
+        }
+    }
+
+    // The next shortest loopless path, if there is one.
+    std::optional<kr_type>
+    operator()()
+    {
+      while(!m_q.empty() && m_q.top().first <= m_ub)
+        {
+          std::size_t n = m_q.top().second;
+          m_q.pop();
+
+          expand(n);
+
+          if (auto r = trace(n))
+            return r;
+
+          ++m_loops;
+        }
+
+      return std::nullopt;
+    }
+
+    // The number of the costs stored.
+    std::size_t
+    stored_costs() const
+    {
+      return m_nodes.size();
+    }
+
+    // The number of the edges stored.
+    std::size_t
+    stored_edges() const
+    {
+      std::size_t result = 0;
+
+      for (const auto &l: m_lists)
+        if (l)
+          result += l.value().size();
+
+      return result;
+    }
+
+  private:
+    // The sidetracks of the vertexes along the tree path from v to t
+    // sorted by delta.
+    const std::vector<sidetrack> &
+    list(Vertex<Graph> v)
+    {
+      // The vertexes along the tree path, whose lists are missing.
+      std::vector<Vertex<Graph>> vs;
+      for (auto u = v; !m_lists[get(m_im, u)]; )
+        {
+          vs.push_back(u);
+
+          if (u == m_t)
+            break;
+
+          u = target(m_next[get(m_im, u)].value(), m_g);
+        }
+
+      // Compute the lists from the end of the tree path.
+      for (auto i = vs.rbegin(); i != vs.rend(); ++i)
+        {
+          auto u = *i;
+          auto &l = m_lists[get(m_im, u)];
+          l.emplace();
+
+          // The list of t is empty, because the paths end at t.
+          if (u == m_t)
+            continue;
+
+          // The sidetracks out of u.
+          std::vector<sidetrack> out;
+          for (auto e: make_iterator_range(out_edges(u, m_g)))
+            if (e != m_next[get(m_im, u)].value())
+              if (auto w = target(e, m_g);
+                  w == m_t || m_next[get(m_im, w)])
+                out.emplace_back(get(m_wm, e) + m_dist[get(m_im, w)] -
+                                 m_dist[get(m_im, u)], e);
+
+          std::sort(out.begin(), out.end());
+
+          const auto &nl = m_lists[get(m_im, target(m_next[get(m_im, u)].
+                                                    value(), m_g))].value();
+          l.value().resize(out.size() + nl.size());
+          std::merge(out.begin(), out.end(), nl.begin(), nl.end(),
+                     l.value().begin());
+        }
+
+      return m_lists[get(m_im, v)].value();
+    }
+
+    // Queue the children of node n.
+    void
+    expand(std::size_t n)
+    {
+      const node nd = m_nodes[n];
+
+      // The path with the next sidetrack of the same list.
+      if (nd.m_rank != npos)
+        {
+          const auto &l = list(nd.m_head);
+          if (nd.m_rank + 1 < l.size())
+            {
+              weight_type c = nd.m_cost - l[nd.m_rank].first +
+                l[nd.m_rank + 1].first;
+              m_nodes.push_back({nd.m_parent, nd.m_head, nd.m_rank + 1, c});
+              m_q.push({c, m_nodes.size() - 1});
+            }
+        }
+
+      // The path extended with the first sidetrack of the list of the
+      // head of the last sidetrack.
+      Vertex<Graph> h = nd.m_rank == npos ? m_s :
+        target(list(nd.m_head)[nd.m_rank].second, m_g);
+      const auto &l = list(h);
+      if (!l.empty())
+        {
+          weight_type c = nd.m_cost + l.front().first;
+          m_nodes.push_back({n, h, 0, c});
+          m_q.push({c, m_nodes.size() - 1});
+        }
+    }
+
+    // The path of node n, unless it has a loop.
+    std::optional<kr_type>
+    trace(std::size_t n)
+    {
+      // The sidetracks of the path, from the last one.
+      std::vector<Edge<Graph>> sts;
+      for (auto i = n; m_nodes[i].m_rank != npos; i = m_nodes[i].m_parent)
+        sts.push_back(list(m_nodes[i].m_head)[m_nodes[i].m_rank].second);
+
+      ++m_stamp;
+      kr_type r;
+      r.first = m_nodes[n].m_cost;
+
+      auto v = m_s;
+      m_visited[get(m_im, v)] = m_stamp;
+
+      // Take edge e to the next vertex, unless it was visited.
+      auto take = [&](const Edge<Graph> &e)
+                  {
+                    r.second.push_back(e);
+                    v = target(e, m_g);
+                    auto &st = m_visited[get(m_im, v)];
+                    if (st == m_stamp)
+                      return false;
+                    st = m_stamp;
+                    return true;
+                  };
+
+      for (auto i = sts.rbegin(); i != sts.rend(); ++i)
+        {
+          // Follow the tree to the source of the sidetrack.
+          while (v != source(*i, m_g))
+            if (!take(m_next[get(m_im, v)].value()))
+              return std::nullopt;
+
+          if (!take(*i))
+            return std::nullopt;
+        }
+
+      // Follow the tree to t.
+      while (v != m_t)
+        if (!take(m_next[get(m_im, v)].value()))
+          return std::nullopt;
+
+      return r;
+    }
+  };
+
+  template <typename Graph, typename WeightMap, typename IndexMap>
+  std::list<std::pair<typename WeightMap::value_type,
+                      std::list<typename Graph::edge_descriptor>>>
+  eppstein_ksp_paths(const Graph& g, Vertex<Graph> s, Vertex<Graph> t,
+                     WeightMap wm, IndexMap im, std::optional<unsigned> K)
+  {
+    using kr_type = Result<typename WeightMap::value_type, Graph>;
+
+    // The shortest paths - these we return.
+    std::list<kr_type> A;
+
+    // An empty result if the source and destination are the same.
+    if (s != t)
+      {
+        eppstein_ksp<Graph, WeightMap, IndexMap> ep(g, s, t, wm, im);
+
+        for (int k = 1; !K || k <= K.value(); ++k)
+          if (auto r = ep())
+            A.push_back(std::move(r.value()));
+          else
+            break;
+      }
+
+    return A;
+  }
+
+} // boost
+
+#endif /* BOOST_GRAPH_EPPSTEIN_KSP */
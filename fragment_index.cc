@@ -0,0 +1,111 @@
+#include "fragment_index.hpp"
+
+using namespace std;
+
+// The fragments are sorted by the number of units, and then by units.
+static bool
+by_count(const CU &a, const CU &b)
+{
+  return a.count() < b.count() || (a.count() == b.count() && a < b);
+}
+
+fragment_index::fragment_index(const SU &su):
+  m_frags(su.begin(), su.end()), m_sums(1)
+{
+  sort(m_frags.begin(), m_frags.end(), by_count);
+
+  m_sums.reserve(m_frags.size() + 1);
+  for(const auto &f: m_frags)
+    m_sums.push_back(m_sums.back() + f.count());
+}
+
+size_t
+fragment_index::lower_bound(int n) const
+{
+  return partition_point(m_frags.begin(), m_frags.end(),
+                         [n](const CU &f){return int(f.count()) < n;})
+    - m_frags.begin();
+}
+
+unsigned long
+fragment_index::placements(int n) const
+{
+  size_t lo = lower_bound(n);
+  size_t hi = m_frags.size();
+  return m_sums[hi] - m_sums[lo] - (n - 1) * (hi - lo);
+}
+
+optional<CU>
+fragment_index::fittest(int n) const
+{
+  size_t lo = lower_bound(n);
+
+  if (lo == m_frags.size())
+    return {};
+
+  return m_frags[lo];
+}
+
+optional<CU>
+fittest(const SU &su, int n)
+{
+  optional<CU> result;
+
+  for(const auto &f: su)
+    if (int(f.count()) >= n && (!result || f.count() < result->count()))
+      result = f;
+
+  return result;
+}
+
+fragment_cache::fragment_cache(graph &g, size_t max):
+  m_gp(&g), m_max(max), m_stamps(index_edges(g).size())
+{
+  assert(max);
+}
+
+bool
+fragment_cache::is_of(const graph &g) const
+{
+  return m_gp == &g;
+}
+
+const fragment_index &
+fragment_cache::get(const path &p, const CU &cu)
+{
+  pair<vector<unsigned>, CU> key(vector<unsigned>(), cu);
+  key.first.reserve(p.size());
+  for(const auto &e: p)
+    key.first.push_back(boost::get(boost::edge_index, *m_gp, e));
+
+  auto i = m_entries.find(key);
+
+  // The index is valid, if no edge changed after it was built.
+  if (i != m_entries.end() &&
+      all_of(key.first.begin(), key.first.end(),
+             [this, i](unsigned j)
+             {return m_stamps[j] <= i->second.m_stamp;}))
+    return i->second.m_fi;
+
+  SU su = intersection(find_path_su(*m_gp, p), SU{cu});
+  entry n{m_stamp, fragment_index(su)};
+
+  if (i != m_entries.end())
+    i->second = std::move(n);
+  else
+    {
+      if (m_entries.size() == m_max)
+        m_entries.clear();
+      i = m_entries.insert(make_pair(std::move(key), std::move(n))).first;
+    }
+
+  return i->second.m_fi;
+}
+
+void
+fragment_cache::update(const path &p)
+{
+  ++m_stamp;
+  for(const auto &e: p)
+    m_stamps[boost::get(boost::edge_index, *m_gp, e)] = m_stamp;
+}
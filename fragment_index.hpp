@@ -0,0 +1,179 @@
+#ifndef FRAGMENT_INDEX_HPP
+#define FRAGMENT_INDEX_HPP
+
+#include "graph.hpp"
+#include "utils.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <map>
+#include <optional>
+#include <utility>
+#include <vector>
+
+// The index of the free fragments (CUs) of an SU, e.g., of a path.
+// The fragments are sorted by their number of units, so that we find
+// the fittest fragment with the binary search, and draw a random
+// fragment without rescanning the SU.
+class fragment_index
+{
+  // The fragments sorted by the number of units, and then by units.
+  std::vector<CU> m_frags;
+
+  // The prefix sums of the number of units: m_sums[i] is the number
+  // of units of the fragments before the i-th fragment.
+  std::vector<unsigned long> m_sums;
+
+  // The index of the first fragment with at least n units.
+  std::size_t
+  lower_bound(int n) const;
+
+public:
+  explicit fragment_index(const SU &su);
+
+  // The number of CUs of n units that we can select.
+  unsigned long
+  placements(int n) const;
+
+  // The smallest fragment with at least n units.  Of the fragments of
+  // the same size, it's the one with the lowest units.
+  std::optional<CU>
+  fittest(int n) const;
+
+  // A CU of n units drawn with the uniform distribution from all CUs
+  // of n units that we can select.
+  template <typename E>
+  std::optional<CU>
+  random(int n, E &eng) const;
+};
+
+template <typename E>
+std::optional<CU>
+fragment_index::random(int n, E &eng) const
+{
+  std::size_t lo = lower_bound(n);
+  unsigned long total = placements(n);
+
+  if (!total)
+    return {};
+
+  // The number of placements in the fragments from lo to i, both
+  // inclusive.  It grows with i, because there is at least one
+  // placement in a fragment.
+  auto cum = [this, lo, n](std::size_t i)
+             {
+               return m_sums[i + 1] - m_sums[lo] - (n - 1) * (i + 1 - lo);
+             };
+
+  // The random placement.
+  unsigned long r = get_random_int(0, total - 1, eng);
+
+  // Find the first fragment i, where cum(i) > r.
+  std::size_t a = lo, b = m_frags.size() - 1;
+  while (a < b)
+    {
+      std::size_t m = (a + b) / 2;
+      if (cum(m) > r)
+        b = m;
+      else
+        a = m + 1;
+    }
+
+  // The offset of the placement in fragment a.
+  unsigned long offset = r - (a == lo ? 0 : cum(a - 1));
+  const CU &f = m_frags[a];
+  assert(offset + n <= f.count());
+
+  return CU(f.min() + offset, f.min() + offset + n);
+}
+
+// The smallest fragment of su with at least n units.  Of the
+// fragments of the same size, it's the one with the lowest units.  The
+// fragments are scanned, and so it's the fittest selection without the
+// index, which pays off only when it's reused.
+std::optional<CU>
+fittest(const SU &su, int n);
+
+// A CU of n units drawn with the uniform distribution from all CUs of
+// n units of su.  The fragments are scanned twice: to count the
+// placements, and to find the one drawn.
+template <typename E>
+std::optional<CU>
+random(const SU &su, int n, E &eng)
+{
+  unsigned long total = 0;
+  for(const auto &f: su)
+    if (int(f.count()) >= n)
+      total += f.count() - n + 1;
+
+  if (!total)
+    return {};
+
+  // The random placement.
+  unsigned long r = get_random_int(0, total - 1, eng);
+
+  for(const auto &f: su)
+    if (int(f.count()) >= n)
+      {
+        unsigned long p = f.count() - n + 1;
+
+        if (r < p)
+          return CU(f.min() + r, f.min() + r + n);
+
+        r -= p;
+      }
+
+  assert(false);
+  return {};
+}
+
+// The cache of the fragment indexes of the paths.  The index of a
+// path is of the units available on all edges of the path within a
+// CU, and it's valid until an edge of the path changes.  An edge,
+// indexed with the edge_index property, has the stamp of its last
+// change, and an index has the stamp of when it was built.  The cache
+// is cleared when it has too many indexes.
+class fragment_cache
+{
+  // The index of a path, and its stamp.
+  struct entry
+  {
+    unsigned long m_stamp;
+    fragment_index m_fi;
+  };
+
+  // The graph.
+  const graph *m_gp;
+
+  // The maximal number of the indexes.
+  std::size_t m_max;
+
+  // The last stamp.
+  unsigned long m_stamp = 0;
+
+  // The stamps of the edges.
+  std::vector<unsigned long> m_stamps;
+
+  // The indexes by the edge indexes of the path and the CU.
+  std::map<std::pair<std::vector<unsigned>, CU>, entry> m_entries;
+
+public:
+  // The edges of the graph are indexed with the edge_index property.
+  explicit fragment_cache(graph &g, std::size_t max = 1 << 16);
+
+  // True if this is the cache of graph g.
+  bool
+  is_of(const graph &g) const;
+
+  // The index of the units available on all edges of path p within
+  // cu.  The index is valid until the next call.
+  const fragment_index &
+  get(const path &p, const CU &cu);
+
+  // Invalidate the indexes of the paths with the edges of path p,
+  // after the units of the edges were taken or released.
+  void
+  update(const path &p);
+};
+
+#endif // FRAGMENT_INDEX_HPP
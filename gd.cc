@@ -5,6 +5,8 @@
 #include "stats.hpp"
 #include "utils.hpp"
 
+#include <thread>
+
 using namespace std;
 
 int
@@ -26,9 +28,36 @@ simulate(const cli_args &args_para)
   if (args.puyenksp)
     routing::add_another_algorithm(routing::rt_t::puyenksp);
 
+  // Search the slots of the parallel search concurrently.
+  routing::set_parallel_threads(args.parallel_threads);
+
+  // Compute the spur paths of the puyenksp search concurrently.
+  routing::set_yen_threads(args.yen_threads);
+
+  // Complete the spur paths with the reverse shortest path tree.
+  routing::set_yen_tree(args.yen_tree);
+
+  // Prune the spur paths with the spectrum of the root paths.
+  routing::set_yen_su(args.yen_su);
+
+  // Use the Eppstein algorithm in the puyenksp search.
+  routing::set_eppstein(args.eppstein);
+
+  // Run the other routing algorithms concurrently.
+  routing::set_xcheck(args.xcheck_threads);
+
+  // Use the memo of the blocked demands.
+  routing::set_memo(args.memo, args.memo_check);
+
+  // Check a sample of the searches in the background.
+  routing::set_verify(args.verify, args.verify_threads);
+
   // Initialize the random number engine of the simulation.
   sim::rne().seed(args.seed);
 
+  // Initialize the random number engine of the spectrum selection.
+  routing::rne().seed(args.seed);
+
   // The graph.
   graph &g = sim::mdl();
 
@@ -38,6 +67,39 @@ simulate(const cli_args &args_para)
 
   set_units(g, args.units);
 
+  // Maintain the counters of the units used and of the fragments.
+  routing::set_counters(g);
+
+  // Select the routing algorithm online.
+  routing::set_auto(g, args.autom, args.explore, args.auto_log);
+
+  // Maintain the sets of the edges with the slots.
+  routing::set_slot_edges(g, args.slot_edges);
+
+  // Maintain the occupancy matrix of the units of the edges.
+  routing::set_occupancy(g, args.occupancy);
+
+  // Maintain the cache of the fragment indexes of the paths.
+  routing::set_fragment_cache(g, args.fragment_cache);
+
+  // Maintain the coarse graph of the coarse-to-fine search with the
+  // given number of units in a super unit.
+  routing::set_c2f(g, args.c2f);
+
+  // Search the slots of the parallel search by branch and bound.
+  routing::set_bnb(g, args.bnb);
+
+  // Maintain the versions of the units of the edges.
+  routing::set_versions(g, args.versions);
+
+  // Maintain the reservation store of the units of the edges.
+  routing::set_reservations(g, args.reservations);
+
+  // Use the library of the K shortest paths computed on all cores.
+  if (args.ksp_lib)
+    routing::set_ksp_library(g, std::thread::hardware_concurrency(),
+                             args.ksp_lib_file);
+
   // Make sure there is only one component.
   assert(is_connected(g));
 
@@ -67,6 +129,13 @@ simulate(const cli_args &args_para)
   // Run the simulation.
   sim::run(args.sim_time);
 
+  // Wait for the other routing algorithms, and the background checks,
+  // so that the stats report them.
+  routing::xcheck_flush();
+
+  if (verifier *v = routing::get_verifier())
+    v->wait();
+
   return 0;
 }
 
@@ -5,6 +5,7 @@
 #include "generic_label_creator.hpp"
 #include "graph.hpp"
 
+#include <limits>
 #include <list>
 #include <optional>
 
@@ -16,7 +17,10 @@ template <typename Label>
 auto
 get_units(const Label &);
 
-template <typename Graph, typename Cost, typename Units>
+// The label creator that removes the CUs with too few units for the
+// cost of the label.  The Model tells the number of units required.
+template <typename Graph, typename Cost, typename Units,
+          typename Model = adaptive_units<Cost>>
 class generic_constrained_label_creator:
   generic_label_creator<Graph, Cost, Units>
 {
@@ -26,18 +30,37 @@ class generic_constrained_label_creator:
   // The number of contiguous units initially requested.
   const int m_ncu;
 
+  // The number of units in a super unit of a coarse graph.  For the
+  // graph with the original units, it's 1.
+  const int m_k;
+
+  // The upper bound on the cost of a label.  There are no labels
+  // created with a larger cost.
+  const Cost m_ub;
+
 public:
-  generic_constrained_label_creator(const Graph &g, int ncu):
-    base(g), m_ncu(ncu)
+  generic_constrained_label_creator(const Graph &g, int ncu, int k = 1,
+                                    Cost ub =
+                                    std::numeric_limits<Cost>::max()):
+    base(g), m_ncu(ncu), m_k(k), m_ub(ub)
   {
   }
 
   std::list<Label>
   operator()(const Edge<Graph> &e, const Label &l) const
   {
-    auto f = [&m_ncu = m_ncu](Cost c, SU &su)
+    auto f = [this](Cost c, SU &su)
              {
-               su.remove(adaptive_units<Cost>::units(m_ncu, c));
+               if (m_ub < c)
+                 su = SU();
+               else
+                 {
+                   int units = Model::units(m_ncu, c);
+                   // The number of super units rounded up.  We don't
+                   // add before dividing, because units can be the
+                   // max int.
+                   su.remove(units / m_k + (units % m_k != 0));
+                 }
              };
 
     return base::operator()(e, l, f);
@@ -30,7 +30,10 @@ typedef double COST;
 
 /**
  * The type of the graph we use.  The edge_su_t property describes the
- * units available, and not already taken.
+ * units available, and not already taken.  The edge_index_t property
+ * is set by index_edges, which is called by the slot_edges, the
+ * occupancy_matrix, the fragment_cache, the coarse_graph, the
+ * ksp_library, the spectrum_store and the reservation_store.
  */
 typedef
 boost::adjacency_list<boost::vecS, boost::vecS, boost::undirectedS,
@@ -38,7 +41,8 @@ boost::adjacency_list<boost::vecS, boost::vecS, boost::undirectedS,
                                       std::string>,
                       boost::property<boost::edge_weight_t, COST,
 		      boost::property<boost::edge_nou_t, unsigned,
-                      boost::property<boost::edge_su_t, SU> > > >
+                      boost::property<boost::edge_su_t, SU,
+                      boost::property<boost::edge_index_t, unsigned> > > > >
 graph;
 
 typedef graph::edge_descriptor edge;
@@ -0,0 +1,254 @@
+#include "ksp_library.hpp"
+
+#include "thread_pool.hpp"
+#include "utils.hpp"
+#include "yen_ksp.hpp"
+
+#include <cassert>
+#include <cstring>
+#include <fstream>
+#include <future>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+
+// The header of the library file.
+struct ksp_header
+{
+  char m_magic[8];
+  uint64_t m_nv, m_ne, m_K, m_hash, m_npaths, m_nids;
+};
+
+static const char ksp_magic[8] = "gdksp02";
+
+// The FNV-1a hash of the end vertexes and the weights of the edges in
+// the order of their indexes.
+static uint64_t
+topology_hash(const graph &g, const vector<edge> &es)
+{
+  uint64_t h = 14695981039346656037ull;
+
+  auto add = [&h](const auto &x)
+             {
+               unsigned char b[sizeof(x)];
+               memcpy(b, &x, sizeof(x));
+               for (auto c: b)
+                 h = (h ^ c) * 1099511628211ull;
+             };
+
+  for(const auto &e: es)
+    {
+      add(uint64_t(boost::source(e, g)));
+      add(uint64_t(boost::target(e, g)));
+      add(double(boost::get(boost::edge_weight, g, e)));
+    }
+
+  return h;
+}
+
+ksp_library::ksp_library(graph &g, unsigned K, unsigned threads,
+                         const optional<string> &file):
+  m_gp(&g), m_nv(num_vertices(g)), m_ne(num_edges(g)), m_K(K),
+  m_edges(index_edges(g)), m_hash(topology_hash(g, m_edges))
+{
+  if (!file || !load(file.value()))
+    {
+      compute(g, threads);
+
+      m_pair_offs = m_pair_offs_v.data();
+      m_path_offs = m_path_offs_v.data();
+      m_costs = m_costs_v.data();
+      m_ids = m_ids_v.data();
+
+      if (file)
+        save(file.value());
+    }
+}
+
+ksp_library::~ksp_library()
+{
+  if (m_map)
+    munmap(m_map, m_size);
+}
+
+void
+ksp_library::compute(const graph &g, unsigned threads)
+{
+  using kr_type = boost::Result<COST, graph>;
+
+  // The paths of the pairs of a source vertex.
+  using paths = vector<list<kr_type>>;
+
+  // The source vertexes are computed by the threads.
+  vector<future<paths>> fs;
+
+  {
+    thread_pool pool(threads);
+
+    for (vertex s = 0; s < m_nv; ++s)
+      fs.push_back(pool.submit([&g, s, this]
+                               {
+                                 paths ps(m_nv);
+                                 for (vertex t = 0; t < m_nv; ++t)
+                                   ps[t] = boost::yen_ksp(g, s, t, m_K);
+                                 return ps;
+                               }));
+  }
+
+  // Flatten the paths in the order of the pairs.
+  m_pair_offs_v.push_back(0);
+  m_path_offs_v.push_back(0);
+
+  for (auto &f: fs)
+    for (const auto &ps: f.get())
+      {
+        for (const auto &[c, p]: ps)
+          {
+            m_costs_v.push_back(c);
+            for (const auto &e: p)
+              m_ids_v.push_back(boost::get(boost::edge_index, g, e));
+            m_path_offs_v.push_back(m_ids_v.size());
+          }
+
+        m_pair_offs_v.push_back(m_costs_v.size());
+      }
+}
+
+bool
+ksp_library::load(const string &file)
+{
+  int fd = open(file.c_str(), O_RDONLY);
+  if (fd < 0)
+    return false;
+
+  struct stat st;
+  if (fstat(fd, &st) || size_t(st.st_size) < sizeof(ksp_header))
+    {
+      close(fd);
+      return false;
+    }
+
+  m_size = st.st_size;
+  m_map = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+
+  if (m_map == MAP_FAILED)
+    {
+      m_map = nullptr;
+      return false;
+    }
+
+  const ksp_header &h = *static_cast<const ksp_header *>(m_map);
+
+  // The size of the file with the arrays.
+  size_t size = sizeof(ksp_header) +
+    (m_nv * m_nv + 1 + h.m_npaths + 1) * sizeof(uint64_t) +
+    h.m_npaths * sizeof(double) + h.m_nids * sizeof(uint32_t);
+
+  if (memcmp(h.m_magic, ksp_magic, sizeof(ksp_magic)) ||
+      h.m_nv != m_nv || h.m_ne != m_ne || h.m_K != m_K ||
+      h.m_hash != m_hash || size != m_size)
+    {
+      munmap(m_map, m_size);
+      m_map = nullptr;
+      return false;
+    }
+
+  // The arrays follow the header.  Their order keeps them aligned.
+  const char *p = static_cast<const char *>(m_map) + sizeof(ksp_header);
+  m_pair_offs = reinterpret_cast<const uint64_t *>(p);
+  p += (m_nv * m_nv + 1) * sizeof(uint64_t);
+  m_path_offs = reinterpret_cast<const uint64_t *>(p);
+  p += (h.m_npaths + 1) * sizeof(uint64_t);
+  m_costs = reinterpret_cast<const double *>(p);
+  p += h.m_npaths * sizeof(double);
+  m_ids = reinterpret_cast<const uint32_t *>(p);
+
+  return true;
+}
+
+void
+ksp_library::save(const string &file) const
+{
+  ksp_header h;
+  memcpy(h.m_magic, ksp_magic, sizeof(ksp_magic));
+  h.m_nv = m_nv;
+  h.m_ne = m_ne;
+  h.m_K = m_K;
+  h.m_hash = m_hash;
+  h.m_npaths = m_costs_v.size();
+  h.m_nids = m_ids_v.size();
+
+  ofstream os(file, ios::binary);
+  os.write(reinterpret_cast<const char *>(&h), sizeof(h));
+  os.write(reinterpret_cast<const char *>(m_pair_offs_v.data()),
+           m_pair_offs_v.size() * sizeof(uint64_t));
+  os.write(reinterpret_cast<const char *>(m_path_offs_v.data()),
+           m_path_offs_v.size() * sizeof(uint64_t));
+  os.write(reinterpret_cast<const char *>(m_costs_v.data()),
+           m_costs_v.size() * sizeof(double));
+  os.write(reinterpret_cast<const char *>(m_ids_v.data()),
+           m_ids_v.size() * sizeof(uint32_t));
+}
+
+bool
+ksp_library::is_of(const graph &g) const
+{
+  return m_gp == &g;
+}
+
+unsigned
+ksp_library::K() const
+{
+  return m_K;
+}
+
+size_t
+ksp_library::count(vertex s, vertex t) const
+{
+  auto i = s * m_nv + t;
+  return m_pair_offs[i + 1] - m_pair_offs[i];
+}
+
+COST
+ksp_library::cost(vertex s, vertex t, size_t k) const
+{
+  assert(k < count(s, t));
+  return m_costs[m_pair_offs[s * m_nv + t] + k];
+}
+
+path
+ksp_library::get(vertex s, vertex t, size_t k) const
+{
+  assert(k < count(s, t));
+  auto p = m_pair_offs[s * m_nv + t] + k;
+
+  path result;
+  for (auto i = m_path_offs[p]; i < m_path_offs[p + 1]; ++i)
+    result.push_back(m_edges[m_ids[i]]);
+
+  return result;
+}
+
+SU
+ksp_library::su(vertex s, vertex t, size_t k) const
+{
+  assert(k < count(s, t));
+  auto p = m_pair_offs[s * m_nv + t] + k;
+
+  // The SU of the first edge, intersected with the others.  A path
+  // has at least one edge, because s != t.
+  auto i = m_path_offs[p];
+  assert(i < m_path_offs[p + 1]);
+  SU result = boost::get(boost::edge_su, *m_gp, m_edges[m_ids[i]]);
+
+  while (++i < m_path_offs[p + 1] && !result.empty())
+    result = intersection(result, boost::get(boost::edge_su, *m_gp,
+                                             m_edges[m_ids[i]]));
+
+  return result;
+}
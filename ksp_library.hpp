@@ -0,0 +1,107 @@
+#ifndef KSP_LIBRARY_HPP
+#define KSP_LIBRARY_HPP
+
+#include "graph.hpp"
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+// The library of the K shortest paths of every node pair.  The paths
+// depend only on the topology and the edge weights, and so they are
+// computed once, with the Yen algorithm, and not for every demand.
+//
+// The paths are stored compactly as arrays of edge ids (the
+// edge_index property), in the layout of the library file: the
+// offsets of the paths of the node pairs, the offsets of the edges of
+// the paths, the costs of the paths, and the edge ids.  The library
+// can be saved to a file, and then the file is memory-mapped, so that
+// the pages of the paths are loaded only when needed.  The file has
+// the hash of the end vertexes and the weights of the edges, and it's
+// used only if the hash of the graph is the same.
+class ksp_library
+{
+  // The graph.
+  const graph *m_gp;
+
+  // The number of vertices, edges, and the K.
+  std::uint64_t m_nv, m_ne, m_K;
+
+  // The edges indexed with the edge_index property.
+  std::vector<edge> m_edges;
+
+  // The hash of the topology and the edge weights.
+  std::uint64_t m_hash;
+
+  // The arrays when computed.
+  std::vector<std::uint64_t> m_pair_offs_v, m_path_offs_v;
+  std::vector<double> m_costs_v;
+  std::vector<std::uint32_t> m_ids_v;
+
+  // The memory-mapped file, and its size.
+  void *m_map = nullptr;
+  std::size_t m_size = 0;
+
+  // The arrays used, either computed or memory-mapped.  The paths of
+  // the pair (s, t) are [m_pair_offs[i], m_pair_offs[i + 1]), where i
+  // = s * m_nv + t.  The edge ids of path p are [m_path_offs[p],
+  // m_path_offs[p + 1]).
+  const std::uint64_t *m_pair_offs;
+  const std::uint64_t *m_path_offs;
+  const double *m_costs;
+  const std::uint32_t *m_ids;
+
+  // Compute the paths with the given number of threads.
+  void
+  compute(const graph &g, unsigned threads);
+
+  // Map the file, and return true if it's a library of this graph.
+  bool
+  load(const std::string &file);
+
+  // Save the library to the file.
+  void
+  save(const std::string &file) const;
+
+public:
+  // The library of at most K paths of graph g.  If the file is given,
+  // and it has the library of the graph, it's used.  Otherwise, the
+  // library is computed with the given number of threads, and saved
+  // to the file.  The edges of g are indexed.
+  ksp_library(graph &g, unsigned K, unsigned threads,
+              const std::optional<std::string> &file = {});
+
+  ~ksp_library();
+
+  ksp_library(const ksp_library &) = delete;
+
+  ksp_library &
+  operator=(const ksp_library &) = delete;
+
+  // True if it's the library of graph g.
+  bool
+  is_of(const graph &g) const;
+
+  // The K.
+  unsigned
+  K() const;
+
+  // The number of paths of the pair.
+  std::size_t
+  count(vertex s, vertex t) const;
+
+  // The cost of the k-th path of the pair.
+  COST
+  cost(vertex s, vertex t, std::size_t k) const;
+
+  // The k-th path of the pair.
+  path
+  get(vertex s, vertex t, std::size_t k) const;
+
+  // The SU available along the k-th path of the pair in the graph.
+  SU
+  su(vertex s, vertex t, std::size_t k) const;
+};
+
+#endif // KSP_LIBRARY_HPP
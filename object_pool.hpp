@@ -0,0 +1,207 @@
+#ifndef OBJECT_POOL_HPP
+#define OBJECT_POOL_HPP
+
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+// The pool of the objects of type T.  The memory is allocated in
+// slabs of many objects, and the memory of a deallocated object is
+// put on the free list, and reused by the next allocation.  The pool
+// only gives the memory: the object is constructed with the placement
+// new, and destroyed explicitly.  The pool is used by one thread.
+template <typename T>
+class object_pool
+{
+  // The memory of an object, or the link of the free list.
+  union slot
+  {
+    slot *m_next;
+    alignas(T) unsigned char m_storage[sizeof(T)];
+  };
+
+  // The number of the objects in a slab.
+  std::size_t m_slab;
+
+  // The slabs.
+  std::vector<std::unique_ptr<slot[]>> m_slabs;
+
+  // The free list.
+  slot *m_free = nullptr;
+
+  // The number of the objects allocated.
+  std::size_t m_size = 0;
+
+public:
+  explicit object_pool(std::size_t slab = 1024): m_slab(slab)
+  {
+    assert(slab);
+  }
+
+  object_pool(const object_pool &) = delete;
+
+  object_pool &
+  operator=(const object_pool &) = delete;
+
+  ~object_pool()
+  {
+    // The objects have to be deallocated.
+    assert(!m_size);
+  }
+
+  // The memory for an object.
+  void *
+  allocate()
+  {
+    if (!m_free)
+      {
+        m_slabs.push_back(std::make_unique<slot[]>(m_slab));
+        slot *s = m_slabs.back().get();
+        for (std::size_t i = 0; i < m_slab; ++i)
+          s[i].m_next = i + 1 < m_slab ? s + i + 1 : nullptr;
+        m_free = s;
+      }
+
+    slot *s = m_free;
+    m_free = s->m_next;
+    ++m_size;
+
+    return s;
+  }
+
+  // Give back the memory of the object destroyed.
+  void
+  deallocate(T *p)
+  {
+    assert(m_size);
+    slot *s = reinterpret_cast<slot *>(p);
+    s->m_next = m_free;
+    m_free = s;
+    --m_size;
+  }
+
+  // The number of the objects allocated.
+  std::size_t
+  size() const
+  {
+    return m_size;
+  }
+
+  // The number of the objects the slabs can hold.
+  std::size_t
+  capacity() const
+  {
+    return m_slabs.size() * m_slab;
+  }
+};
+
+// The storage of the pool allocator for the blocks of the given size
+// and alignment.  Every thread has its slabs and its free list, and
+// the slabs are freed when the thread exits.  Therefore a block has to
+// be deallocated by the thread that allocated it, and before that
+// thread exits: the allocator is not for the objects passed between
+// the threads.
+template <std::size_t Size, std::size_t Align>
+class pool_storage
+{
+  // The block, or the link of the free list.
+  union slot
+  {
+    slot *m_next;
+    alignas(Align) unsigned char m_storage[Size];
+  };
+
+  // The number of the blocks in a slab.
+  static constexpr std::size_t slab = 1024;
+
+  // The slabs and the free list of a thread.
+  struct local
+  {
+    std::vector<std::unique_ptr<slot[]>> m_slabs;
+    slot *m_free = nullptr;
+  };
+
+  static inline thread_local local t_local;
+
+public:
+  static void *
+  allocate()
+  {
+    local &l = t_local;
+
+    if (!l.m_free)
+      {
+        l.m_slabs.push_back(std::make_unique<slot[]>(slab));
+        slot *s = l.m_slabs.back().get();
+        for (std::size_t i = 0; i < slab; ++i)
+          s[i].m_next = i + 1 < slab ? s + i + 1 : nullptr;
+        l.m_free = s;
+      }
+
+    slot *s = l.m_free;
+    l.m_free = s->m_next;
+
+    return s;
+  }
+
+  static void
+  deallocate(void *p)
+  {
+    local &l = t_local;
+    slot *s = static_cast<slot *>(p);
+    s->m_next = l.m_free;
+    l.m_free = s;
+  }
+};
+
+// The allocator that takes the single objects, such as the nodes of a
+// list, from the pool storage of the thread, and the arrays from
+// std::allocator.
+template <typename T>
+struct pool_allocator
+{
+  using value_type = T;
+
+  pool_allocator() = default;
+
+  template <typename U>
+  pool_allocator(const pool_allocator<U> &)
+  {
+  }
+
+  T *
+  allocate(std::size_t n)
+  {
+    if (n == 1)
+      return static_cast<T *>(pool_storage<sizeof(T),
+                                           alignof(T)>::allocate());
+
+    return std::allocator<T>().allocate(n);
+  }
+
+  void
+  deallocate(T *p, std::size_t n)
+  {
+    if (n == 1)
+      pool_storage<sizeof(T), alignof(T)>::deallocate(p);
+    else
+      std::allocator<T>().deallocate(p, n);
+  }
+};
+
+template <typename T, typename U>
+bool
+operator==(const pool_allocator<T> &, const pool_allocator<U> &)
+{
+  return true;
+}
+
+template <typename T, typename U>
+bool
+operator!=(const pool_allocator<T> &, const pool_allocator<U> &)
+{
+  return false;
+}
+
+#endif // OBJECT_POOL_HPP
@@ -0,0 +1,227 @@
+#include "occupancy_matrix.hpp"
+#include "utils.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+using namespace std;
+
+using word = occupancy_matrix::word;
+
+// Call f(begin, end) for the runs of the set bits in words [lo, hi]
+// of b, until f returns true.
+template <typename F>
+static void
+for_each_run(const word *b, size_t lo, size_t hi, F f)
+{
+  constexpr unsigned bits = occupancy_matrix::bits;
+
+  const size_t end = (hi + 1) * bits;
+
+  for (size_t i = lo * bits; i < end;)
+    {
+      // The first set bit from i.
+      size_t w = i / bits;
+      word x = b[w] & ~word(0) << i % bits;
+      while (!x && ++w <= hi)
+        x = b[w];
+      if (w > hi)
+        return;
+      size_t s = w * bits + __builtin_ctzll(x);
+
+      // The first clear bit from s.
+      w = s / bits;
+      x = ~b[w] & ~word(0) << s % bits;
+      while (!x && ++w <= hi)
+        x = ~b[w];
+      size_t e = w > hi ? end : w * bits + __builtin_ctzll(x);
+
+      if (f(s, e))
+        return;
+
+      i = e;
+    }
+}
+
+occupancy_matrix::occupancy_matrix(graph &g): m_gp(&g)
+{
+  auto es = index_edges(g);
+
+  for(const auto &e: es)
+    m_nou.push_back(boost::get(boost::edge_nou, g, e));
+
+  // The number of lines of a row.
+  unsigned nou = m_nou.empty() ? 0 :
+    *max_element(m_nou.begin(), m_nou.end());
+  m_lpr = max<size_t>(1, (nou + wpl * bits - 1) / (wpl * bits));
+  m_lines.resize(es.size() * m_lpr, line{});
+
+  for (size_t i = 0; i < es.size(); ++i)
+    for_each_word(boost::get(boost::edge_su, g, es[i]),
+                  [r = row(i)](size_t w, word m)
+                  {
+                    r[w] |= m;
+                  });
+}
+
+occupancy_matrix::word *
+occupancy_matrix::row(size_t i)
+{
+  return m_lines[i * m_lpr].m_w;
+}
+
+const occupancy_matrix::word *
+occupancy_matrix::row(size_t i) const
+{
+  return m_lines[i * m_lpr].m_w;
+}
+
+void
+occupancy_matrix::set(size_t i, const CU &cu, bool available)
+{
+  assert(cu.max() <= m_nou[i]);
+
+  for_each_word(cu, [r = row(i), available](size_t w, word m)
+                    {
+                      if (available)
+                        r[w] |= m;
+                      else
+                        r[w] &= ~m;
+                    });
+}
+
+const occupancy_matrix::word *
+occupancy_matrix::path_and(const path &p, const CU &cu) const
+{
+  // The buffer of the thread.
+  static thread_local vector<word> buf;
+  buf.resize(m_lpr * wpl);
+
+  size_t lo = cu.min() / bits;
+  size_t hi = (cu.max() - 1) / bits;
+
+  for (size_t w = lo; w <= hi; ++w)
+    buf[w] = unit_mask(cu.min(), cu.max(), w);
+
+  for(const auto &e: p)
+    {
+      const word *r = row(boost::get(boost::edge_index, *m_gp, e));
+      for (size_t w = lo; w <= hi; ++w)
+        buf[w] &= r[w];
+    }
+
+  return buf.data();
+}
+
+bool
+occupancy_matrix::is_of(const graph &g) const
+{
+  return m_gp == &g;
+}
+
+void
+occupancy_matrix::allocate(const cupath &p)
+{
+  for(const auto &e: p.second)
+    set(boost::get(boost::edge_index, *m_gp, e), p.first, false);
+}
+
+void
+occupancy_matrix::release(const cupath &p)
+{
+  for(const auto &e: p.second)
+    set(boost::get(boost::edge_index, *m_gp, e), p.first, true);
+}
+
+bool
+occupancy_matrix::available(const cupath &p) const
+{
+  const CU &cu = p.first;
+
+  if (!cu.count())
+    return true;
+
+  const word *b = path_and(p.second, cu);
+
+  for (size_t w = cu.min() / bits; w * bits < cu.max(); ++w)
+    if (b[w] != unit_mask(cu.min(), cu.max(), w))
+      return false;
+
+  return true;
+}
+
+SU
+occupancy_matrix::path_su(const path &p, const CU &cu) const
+{
+  SU result;
+
+  if (!cu.count())
+    return result;
+
+  const word *b = path_and(p, cu);
+
+  for_each_run(b, cu.min() / bits, (cu.max() - 1) / bits,
+               [&result](size_t s, size_t e)
+               {
+                 result.insert(CU(s, e));
+                 return false;
+               });
+
+  return result;
+}
+
+optional<CU>
+occupancy_matrix::first_fit(const path &p, const CU &cu, int n) const
+{
+  assert(n > 0);
+
+  optional<CU> result;
+
+  if (int(cu.count()) < n)
+    return result;
+
+  const word *b = path_and(p, cu);
+
+  for_each_run(b, cu.min() / bits, (cu.max() - 1) / bits,
+               [&result, n](size_t s, size_t e)
+               {
+                 if (e - s >= size_t(n))
+                   result = CU(s, s + n);
+                 return bool(result);
+               });
+
+  return result;
+}
+
+double
+occupancy_matrix::utilization() const
+{
+  if (m_nou.empty())
+    return 0;
+
+  double sum = 0;
+
+  for (size_t i = 0; i < m_nou.size(); ++i)
+    {
+      const word *r = row(i);
+      unsigned available = 0;
+      for (size_t w = 0; w < m_lpr * wpl; ++w)
+        available += __builtin_popcountll(r[w]);
+      sum += double(m_nou[i] - available) / m_nou[i];
+    }
+
+  return sum / m_nou.size();
+}
+
+occupancy_matrix::snapshot_type
+occupancy_matrix::snapshot() const
+{
+  return m_lines;
+}
+
+void
+occupancy_matrix::restore(const snapshot_type &s)
+{
+  assert(s.size() == m_lines.size());
+  m_lines = s;
+}
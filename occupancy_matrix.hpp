@@ -0,0 +1,109 @@
+#ifndef OCCUPANCY_MATRIX_HPP
+#define OCCUPANCY_MATRIX_HPP
+
+#include "graph.hpp"
+#include "unit_words.hpp"
+
+#include <optional>
+#include <vector>
+
+// The occupancy matrix of the units of the edges.  A row is the
+// bitmap of the units of an edge indexed with the edge_index
+// property, and a bit is set if the unit is available.  The rows are
+// padded to whole cache lines, and stored in one block of memory
+// aligned to 64 bytes, so that the operations on the rows are the
+// loops over the words, which the compiler vectorizes.  A snapshot of
+// the matrix is a copy of the block.
+class occupancy_matrix
+{
+public:
+  using word = unit_word;
+
+  // The number of bits of a word.
+  static constexpr unsigned bits = unit_bits;
+
+private:
+  // The number of words of a cache line.
+  static constexpr unsigned wpl = 64 / sizeof(word);
+
+  // The cache line.
+  struct alignas(64) line
+  {
+    word m_w[wpl];
+  };
+
+  // The graph.
+  const graph *m_gp;
+
+  // The number of lines of a row.
+  std::size_t m_lpr = 0;
+
+  // The numbers of units of the edges.
+  std::vector<unsigned> m_nou;
+
+  // The lines of the rows.
+  std::vector<line> m_lines;
+
+  // The words of row i.
+  word *
+  row(std::size_t i);
+
+  const word *
+  row(std::size_t i) const;
+
+  // Set the bits of the units of cu in row i, if available is true,
+  // and clear them otherwise.
+  void
+  set(std::size_t i, const CU &cu, bool available);
+
+  // AND the rows of path p within cu into the buffer, and return the
+  // buffer.  The words of the buffer outside cu are not set.
+  const word *
+  path_and(const path &p, const CU &cu) const;
+
+public:
+  // The snapshot of the matrix.
+  using snapshot_type = std::vector<line>;
+
+  // The edges of the graph are indexed with the edge_index property.
+  explicit occupancy_matrix(graph &g);
+
+  // True if this is the matrix of graph g.
+  bool
+  is_of(const graph &g) const;
+
+  // Take the units of the path.
+  void
+  allocate(const cupath &p);
+
+  // Release the units of the path.
+  void
+  release(const cupath &p);
+
+  // True if the units of the path are available on all its edges.
+  bool
+  available(const cupath &p) const;
+
+  // The units available along the path within cu.
+  SU
+  path_su(const path &p, const CU &cu) const;
+
+  // The first CU of n units available along the path within cu.
+  std::optional<CU>
+  first_fit(const path &p, const CU &cu, int n) const;
+
+  // The mean utilization of the edges.
+  double
+  utilization() const;
+
+  // The snapshot of the matrix, which doesn't follow the matrix.
+  snapshot_type
+  snapshot() const;
+
+  // Restore the matrix to the snapshot taken from it.  The SUs of the
+  // graph are not restored.
+  void
+  restore(const snapshot_type &s);
+};
+
+#endif // OCCUPANCY_MATRIX_HPP
@@ -0,0 +1,113 @@
+#ifndef ONLINE_SELECTOR_HPP
+#define ONLINE_SELECTOR_HPP
+
+#include <algorithm>
+#include <cassert>
+#include <map>
+#include <set>
+#include <utility>
+
+// The online selector of an algorithm.  For the given features of a
+// problem, it selects the algorithm with the lowest mean time.  The
+// mean is exact for the first samples, and then it's the exponential
+// moving mean of about the last window samples, so that the old
+// samples are forgotten.  Every so often, it explores the other
+// algorithms, so that it keeps learning while the conditions change.
+template <typename Algo, typename Features>
+class online_selector
+{
+  // The running performance of an algorithm.
+  struct perf
+  {
+    // The number of samples.
+    unsigned long m_n = 0;
+    // The mean time, exact or moving.
+    double m_mean = 0;
+  };
+
+  // The candidate algorithms.
+  std::set<Algo> m_cands;
+
+  // Every how many decisions we explore.
+  unsigned m_explore;
+
+  // The minimal number of samples before we exploit an algorithm.
+  unsigned m_min_samples;
+
+  // The number of the samples the moving mean is about.
+  unsigned m_window;
+
+  // The number of decisions made.
+  unsigned long m_decisions = 0;
+
+  // The performance of the algorithms for the given features.
+  std::map<Features, std::map<Algo, perf>> m_perf;
+
+public:
+  online_selector(unsigned explore = 20, unsigned min_samples = 3,
+                  unsigned window = 100):
+    m_explore(explore), m_min_samples(min_samples), m_window(window)
+  {
+    assert(window);
+  }
+
+  // Set the candidate algorithms.
+  void
+  set_candidates(const std::set<Algo> &cands)
+  {
+    m_cands = cands;
+  }
+
+  // True if the algorithm is a candidate.
+  bool
+  is_candidate(const Algo &a) const
+  {
+    return m_cands.count(a);
+  }
+
+  // Select an algorithm for the given features.  The second element
+  // is true if the algorithm was selected to explore.
+  std::pair<Algo, bool>
+  select(const Features &f)
+  {
+    assert(!m_cands.empty());
+
+    ++m_decisions;
+    auto &pm = m_perf[f];
+
+    // The candidate with the fewest samples, and the fastest one.
+    const Algo *fewest = nullptr, *fastest = nullptr;
+
+    for(const auto &a: m_cands)
+      {
+        const perf &p = pm[a];
+
+        if (!fewest || p.m_n < pm[*fewest].m_n)
+          fewest = &a;
+
+        if (p.m_n && (!fastest || p.m_mean < pm[*fastest].m_mean))
+          fastest = &a;
+      }
+
+    // We don't know enough yet, or it's time to explore.
+    if (pm[*fewest].m_n < m_min_samples ||
+        (m_explore && m_decisions % m_explore == 0))
+      return std::make_pair(*fewest, true);
+
+    return std::make_pair(*fastest, false);
+  }
+
+  // Record the time the algorithm took for the given features.
+  void
+  record(const Features &f, const Algo &a, double dt)
+  {
+    if (is_candidate(a))
+      {
+        perf &p = m_perf[f][a];
+        unsigned long n = std::min<unsigned long>(++p.m_n, m_window);
+        p.m_mean += (dt - p.m_mean) / n;
+      }
+  }
+};
+
+#endif // ONLINE_SELECTOR_HPP
@@ -0,0 +1,305 @@
+#ifndef PROCESS_HPP
+#define PROCESS_HPP
+
+#include "module.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <new>
+#include <utility>
+#include <vector>
+
+// =======================================================================
+// The processes of the simulation written as coroutines.  A process
+// starts when it's called, and runs until it awaits sleep_until(t).
+// Then it's resumed by the event at time t of the simulation, the
+// same way a module is called by its event.  The process object
+// owns the frame, and destroys it when the object is destroyed.  A
+// process started in the simulation is kept in the process set until
+// it returns.
+//
+// For example, the lifecycle of a client:
+//
+// process<sim>
+// lifecycle(...)
+// {
+//   set up;
+//   co_await sleep_until<sim>(sim::now() + holding time);
+//   tear down;
+// }
+//
+// The frames are allocated from the frame pool.
+// =======================================================================
+
+// The pool of the coroutine frames.  The frames are rounded up to the
+// size classes, and every thread has the free lists of the frames of
+// the classes.  A free list keeps a limited number of frames, and the
+// frames above the limit are deleted, and so are the frames of the
+// free lists when the thread exits.  The frames larger than the
+// largest class are allocated with the operator new.
+class frame_pool
+{
+  // The granularity of the size classes.
+  static constexpr std::size_t grain = 64;
+
+  // The number of the size classes.
+  static constexpr std::size_t classes = 16;
+
+  // The maximal number of the frames of a free list.
+  static constexpr std::size_t max_free = 1024;
+
+  // The free frame, or the link of the free list.
+  struct node
+  {
+    node *m_next;
+  };
+
+  // The free lists of a thread by the size classes.
+  struct lists
+  {
+    std::array<node *, classes> m_free{};
+    std::array<std::size_t, classes> m_count{};
+
+    ~lists()
+    {
+      for (node *f: m_free)
+        while (f)
+          ::operator delete(std::exchange(f, f->m_next));
+    }
+  };
+
+  static thread_local lists t_lists;
+
+  // The size class of n bytes.
+  static std::size_t
+  size_class(std::size_t n)
+  {
+    return (n + grain - 1) / grain - 1;
+  }
+
+public:
+  static void *
+  allocate(std::size_t n)
+  {
+    std::size_t c = size_class(n);
+
+    if (c >= classes)
+      return ::operator new(n);
+
+    lists &l = t_lists;
+
+    if (node *f = l.m_free[c])
+      {
+        l.m_free[c] = f->m_next;
+        --l.m_count[c];
+        return f;
+      }
+
+    return ::operator new((c + 1) * grain);
+  }
+
+  static void
+  deallocate(void *p, std::size_t n)
+  {
+    std::size_t c = size_class(n);
+
+    lists &l = t_lists;
+
+    if (c >= classes || l.m_count[c] == max_free)
+      ::operator delete(p);
+    else
+      {
+        node *f = static_cast<node *>(p);
+        f->m_next = l.m_free[c];
+        l.m_free[c] = f;
+        ++l.m_count[c];
+      }
+  }
+};
+
+inline thread_local frame_pool::lists frame_pool::t_lists;
+
+// The coroutine type of a process of simulation S.
+template <typename S>
+class process
+{
+public:
+  // The promise is the module that resumes the process when its
+  // event comes.
+  struct promise_type: module<S>
+  {
+    void
+    operator()(typename S::time_type) override
+    {
+      std::coroutine_handle<promise_type>::from_promise(*this).resume();
+    }
+
+    process
+    get_return_object()
+    {
+      return process(std::coroutine_handle<promise_type>::
+                     from_promise(*this));
+    }
+
+    std::suspend_never
+    initial_suspend() noexcept
+    {
+      return {};
+    }
+
+    // The frame is destroyed by the owner.
+    std::suspend_always
+    final_suspend() noexcept
+    {
+      return {};
+    }
+
+    void
+    return_void()
+    {
+    }
+
+    void
+    unhandled_exception()
+    {
+      std::terminate();
+    }
+
+    static void *
+    operator new(std::size_t n)
+    {
+      return frame_pool::allocate(n);
+    }
+
+    static void
+    operator delete(void *p, std::size_t n)
+    {
+      frame_pool::deallocate(p, n);
+    }
+  };
+
+private:
+  std::coroutine_handle<promise_type> m_h;
+
+  explicit process(std::coroutine_handle<promise_type> h): m_h(h)
+  {
+  }
+
+public:
+  process(process &&p): m_h(std::exchange(p.m_h, nullptr))
+  {
+  }
+
+  process &
+  operator=(process &&p)
+  {
+    if (this != &p)
+      {
+        if (m_h)
+          m_h.destroy();
+        m_h = std::exchange(p.m_h, nullptr);
+      }
+
+    return *this;
+  }
+
+  // Destroy the frame.  A sleeping process is destroyed only when
+  // the simulation doesn't run anymore, because its event stays in
+  // the queue of the simulation.
+  ~process()
+  {
+    if (m_h)
+      m_h.destroy();
+  }
+
+  // True if the process returned.
+  bool
+  done() const
+  {
+    return m_h.done();
+  }
+};
+
+// The set of the processes started in the simulation.  The processes
+// that returned are destroyed when the set grows, and the processes
+// still sleeping are destroyed with the set, which has to be torn
+// down after the simulation stops.
+template <typename S>
+class process_set
+{
+  // The minimal size of the set when it's pruned.
+  static constexpr std::size_t min_prune = 16;
+
+  std::vector<process<S>> m_ps;
+
+  // The size of the set at which it's pruned.
+  std::size_t m_prune = min_prune;
+
+public:
+  // Keep the process until it returns.
+  void
+  start(process<S> &&p)
+  {
+    if (p.done())
+      return;
+
+    // The pruning is amortized over the processes started.
+    if (m_ps.size() == m_prune)
+      {
+        prune();
+        m_prune = std::max(min_prune, 2 * m_ps.size());
+      }
+
+    m_ps.push_back(std::move(p));
+  }
+
+  // Destroy the processes that returned.
+  void
+  prune()
+  {
+    std::erase_if(m_ps, [](const process<S> &p){return p.done();});
+  }
+
+  // The number of the processes kept.
+  std::size_t
+  size() const
+  {
+    return m_ps.size();
+  }
+};
+
+// The awaitable that suspends the process until time t of the
+// simulation.
+template <typename S>
+struct sleep_until
+{
+  typename S::time_type m_t;
+
+  explicit sleep_until(typename S::time_type t): m_t(t)
+  {
+  }
+
+  bool
+  await_ready() const noexcept
+  {
+    return false;
+  }
+
+  void
+  await_suspend(std::coroutine_handle<typename process<S>::promise_type>
+                h) const
+  {
+    h.promise().schedule(m_t);
+  }
+
+  void
+  await_resume() const noexcept
+  {
+  }
+};
+
+#endif // PROCESS_HPP
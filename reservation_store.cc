@@ -0,0 +1,161 @@
+#include "reservation_store.hpp"
+#include "utils.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+using namespace std;
+
+using word = reservation_store::word;
+
+reservation_store::reservation_store(graph &g): m_gp(&g)
+{
+  auto es = index_edges(g);
+
+  for(const auto &e: es)
+    m_nou.push_back(boost::get(boost::edge_nou, g, e));
+
+  unsigned nou = m_nou.empty() ? 0 :
+    *max_element(m_nou.begin(), m_nou.end());
+  m_wpr = max<size_t>(1, (nou + bits - 1) / bits);
+  m_words = make_unique<atomic<word>[]>(es.size() * m_wpr);
+
+  for (size_t i = 0; i < es.size(); ++i)
+    {
+      atomic<word> *r = row(i);
+
+      for (size_t w = 0; w < m_wpr; ++w)
+        r[w].store(0, memory_order_relaxed);
+
+      for_each_word(boost::get(boost::edge_su, g, es[i]),
+                    [r](size_t w, word m)
+                    {
+                      r[w].fetch_or(m, memory_order_relaxed);
+                    });
+    }
+}
+
+bool
+reservation_store::is_of(const graph &g) const
+{
+  return m_gp == &g;
+}
+
+atomic<word> *
+reservation_store::row(size_t i) const
+{
+  return &m_words[i * m_wpr];
+}
+
+bool
+reservation_store::take(size_t i, const CU &cu)
+{
+  assert(cu.max() <= m_nou[i]);
+
+  atomic<word> *r = row(i);
+  const size_t first = cu.min() / bits;
+
+  for (size_t w = first; w * bits < cu.max(); ++w)
+    {
+      word m = unit_mask(cu.min(), cu.max(), w);
+      word x = r[w].load(memory_order_relaxed);
+
+      while (true)
+        {
+          if ((x & m) != m)
+            {
+              // Put back the words taken in the reverse order.
+              while (w-- > first)
+                r[w].fetch_or(unit_mask(cu.min(), cu.max(), w),
+                              memory_order_release);
+              return false;
+            }
+
+          if (r[w].compare_exchange_weak(x, x & ~m, memory_order_acquire,
+                                         memory_order_relaxed))
+            break;
+
+          ++m_retries;
+        }
+    }
+
+  return true;
+}
+
+void
+reservation_store::put(size_t i, const CU &cu)
+{
+  assert(cu.max() <= m_nou[i]);
+
+  for_each_word(cu, [r = row(i)](size_t w, word m)
+                    {
+                      word x = r[w].fetch_or(m, memory_order_release);
+                      // The units have to be taken.
+                      assert(!(x & m));
+                    });
+}
+
+bool
+reservation_store::reserve(const cupath &p)
+{
+  // The indexes of the edges reserved.
+  vector<size_t> done;
+
+  for(const auto &e: p.second)
+    {
+      size_t i = boost::get(boost::edge_index, *m_gp, e);
+
+      if (!take(i, p.first))
+        {
+          // Roll back the edges reserved in the reverse order.
+          for (auto j = done.rbegin(); j != done.rend(); ++j)
+            put(*j, p.first);
+
+          ++m_conflicts;
+          return false;
+        }
+
+      done.push_back(i);
+    }
+
+  return true;
+}
+
+void
+reservation_store::release(const cupath &p)
+{
+  for(const auto &e: p.second)
+    put(boost::get(boost::edge_index, *m_gp, e), p.first);
+}
+
+bool
+reservation_store::available(const cupath &p) const
+{
+  const CU &cu = p.first;
+
+  for(const auto &e: p.second)
+    {
+      atomic<word> *r = row(boost::get(boost::edge_index, *m_gp, e));
+
+      for (size_t w = cu.min() / bits; w * bits < cu.max(); ++w)
+        {
+          word m = unit_mask(cu.min(), cu.max(), w);
+          if ((r[w].load(memory_order_acquire) & m) != m)
+            return false;
+        }
+    }
+
+  return true;
+}
+
+unsigned long
+reservation_store::retries() const
+{
+  return m_retries;
+}
+
+unsigned long
+reservation_store::conflicts() const
+{
+  return m_conflicts;
+}
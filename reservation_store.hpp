@@ -0,0 +1,101 @@
+#ifndef RESERVATION_STORE_HPP
+#define RESERVATION_STORE_HPP
+
+#include "graph.hpp"
+#include "unit_words.hpp"
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+// The store of the reservations of the units of the edges for the
+// concurrent allocation.  A row is the bitmap of the units of an edge
+// indexed with the edge_index property, and a bit is set if the unit
+// is available.  The words of the rows are atomic: the units are
+// taken with the compare-and-swap of a word, and put back with the
+// atomic OR, and so the threads don't lock.
+//
+// A path is reserved all or nothing: when the units of an edge are
+// taken by another thread, the words and the edges already reserved
+// are put back in the reverse order, and the reservation fails
+// without waiting.
+//
+// The store has a single writer: only the thread that sets up and
+// tears down the paths in the graph releases the units in the store.
+// The other threads only reserve, and only the units they found
+// available in the graph.  The units released in the store are taken
+// in the graph until the writer changes the graph, and so the writer
+// can reserve them again when it undoes a batch it failed to apply.
+class reservation_store
+{
+public:
+  using word = unit_word;
+
+  // The number of bits of a word.
+  static constexpr unsigned bits = unit_bits;
+
+private:
+  // The graph.
+  const graph *m_gp;
+
+  // The number of words of a row.
+  std::size_t m_wpr = 0;
+
+  // The numbers of units of the edges.
+  std::vector<unsigned> m_nou;
+
+  // The words of the rows.
+  std::unique_ptr<std::atomic<word>[]> m_words;
+
+  // The number of the compare-and-swaps retried, because another
+  // thread changed the word.
+  std::atomic<unsigned long> m_retries{0};
+
+  // The number of the reservations failed, because another thread
+  // took the units.
+  std::atomic<unsigned long> m_conflicts{0};
+
+  // The words of row i.
+  std::atomic<word> *
+  row(std::size_t i) const;
+
+  // Take the units of cu on edge i.  If they are not available, the
+  // words already taken are put back, and false is returned.
+  bool
+  take(std::size_t i, const CU &cu);
+
+  // Put back the units of cu on edge i.
+  void
+  put(std::size_t i, const CU &cu);
+
+public:
+  // The edges of the graph are indexed with the edge_index property.
+  explicit reservation_store(graph &g);
+
+  // True if this is the store of graph g.
+  bool
+  is_of(const graph &g) const;
+
+  // Reserve the units of the path on all its edges, or on none.  True
+  // is returned if the path was reserved.
+  bool
+  reserve(const cupath &p);
+
+  // Release the units of the path reserved.
+  void
+  release(const cupath &p);
+
+  // True if the units of the path are available on all its edges.
+  bool
+  available(const cupath &p) const;
+
+  // The number of the compare-and-swaps retried.
+  unsigned long
+  retries() const;
+
+  // The number of the reservations failed.
+  unsigned long
+  conflicts() const;
+};
+
+#endif // RESERVATION_STORE_HPP
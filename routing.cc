@@ -8,7 +8,13 @@
 #include "accountant.hpp"
 #include "accounted_solution.hpp"
 #include "adaptive_units.hpp"
+#include "coarse_graph.hpp"
 #include "custom_dijkstra_call.hpp"
+#include "distance_cache.hpp"
+#include "edge_counters.hpp"
+#include "edge_has_units.hpp"
+#include "eppstein_ksp.hpp"
+#include "fragment_index.hpp"
 #include "generic_dijkstra.hpp"
 #include "generic_constrained_label_creator.hpp"
 #include "generic_label.hpp"
@@ -16,6 +22,10 @@
 #include "generic_tentative.hpp"
 #include "generic_tracer.hpp"
 #include "graph.hpp"
+#include "ksp_library.hpp"
+#include "routing_engine.hpp"
+#include "slot_edges.hpp"
+#include "spectrum_root.hpp"
 #include "stats.hpp"
 #include "standard_dijkstra.hpp"
 #include "standard_constrained_label_creator.hpp"
@@ -27,27 +37,109 @@
 #include "yen_ksp.hpp"
 #include "utils.hpp"
 
+#include <boost/dynamic_bitset.hpp>
+#include <boost/graph/dijkstra_shortest_paths.hpp>
 #include <boost/range.hpp>
 
 #include <algorithm>
 #include <climits>
 #include <chrono>
+#include <future>
+#include <cmath>
 #include <iterator>
+#include <limits>
 #include <list>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <optional>
+#include <queue>
 #include <set>
+#include <sstream>
 #include <tuple>
+#include <type_traits>
+#include <vector>
 
 using namespace std;
 
 routing::st_t routing::m_st = routing::st_t::none;
 
+map<routing::rt_t, unique_ptr<basic_engine>> routing::m_engines;
+
 // Another routing algorithms to use.
 set<routing::rt_t> routing::m_aras;
 
 optional<unsigned> routing::m_K;
 
+unique_ptr<coarse_graph> routing::m_cg;
+
+unique_ptr<distance_cache> routing::m_dc;
+
+bool routing::m_auto = false;
+
+bool routing::m_auto_log = false;
+
+online_selector<routing::rt_t, routing::features> routing::m_os;
+
+routing::features routing::m_af;
+
+const graph *routing::m_ag = nullptr;
+
+map<npair, int> routing::m_hd;
+
+bool routing::m_memo = false;
+
+bool routing::m_memo_check = false;
+
+blocked_memo routing::m_bm;
+
+unsigned long routing::m_release_epoch = 0;
+
+default_random_engine routing::m_rne;
+
+unique_ptr<verifier> routing::m_ver;
+
+unique_ptr<thread_pool> routing::m_xpool;
+
+deque<routing::xcheck> routing::m_xchecks;
+
+unique_ptr<thread_pool> routing::m_ppool;
+
+bool routing::m_bnb = false;
+
+unique_ptr<slot_edges> routing::m_se;
+
+unique_ptr<occupancy_matrix> routing::m_om;
+
+unique_ptr<fragment_cache> routing::m_fc;
+
+unique_ptr<edge_counters> routing::m_ec;
+
+unique_ptr<spectrum_store> routing::m_ss;
+
+unique_ptr<reservation_store> routing::m_rs;
+
+unique_ptr<ksp_library> routing::m_kl;
+
+unique_ptr<thread_pool> routing::m_ypool;
+
+bool routing::m_yen_tree = false;
+
+bool routing::m_yen_su = false;
+
+bool routing::m_eppstein = false;
+
+// True in the worker threads of the cross-checks.  The workers don't
+// touch the shared state: they select the units first-fit, because
+// the cross-check compares only the numbers of units and the costs,
+// and they don't report stats.
+static thread_local bool xcheck_worker = false;
+
+// The maximal number of cross-checks pending.  Every pending
+// cross-check keeps a snapshot of the graph, and so above that we
+// wait for the oldest.
+static constexpr std::size_t max_xchecks = 64;
+
 optional<cupath>
 routing::set_up(graph &g, const demand &d)
 {
@@ -72,38 +164,103 @@ routing::set_up(graph &g, const demand &d, const CU &cu)
 
   assert (src != dst);
 
-  auto dr = search(g, d, cu, rt_t::dijkstra);
+  // Compare the results of the cross-checks that finished.
+  if (m_xpool)
+    xcheck_collect(false);
 
-  for(const auto ara: m_aras)
+  // Nothing was released since the demand was blocked, so the search
+  // would fail again.
+  if (m_memo && m_bm.is_blocked(d, cu, m_release_epoch))
     {
-      // Another result.
-      auto ar = search(g, d, cu, ara);
+      stats::get().memo_hit();
 
-      if (!(!dr && !ar ||
-            dr.value().first.count() == ar.value().first.count() &&
-            get_cost(g, dr.value()) == get_cost(g, ar.value())))
+      // Make sure the search fails indeed.  We call search_dijkstra,
+      // and not search, so that the algorithm stats are not skewed.
+      if (m_memo_check && get<3>(search_dijkstra(g, d, cu)))
         {
-          cout << "dr = " << dr.value() << endl
-               << "ar = " << ar.value() << endl;
+          cout << "memo hit, but the demand is not blocked: "
+               << d << endl;
           abort();
         }
+
+      return {};
+    }
+
+  // The primary routing algorithm, whose result we set up.
+  rt_t prt = m_auto ? auto_select(g, d) : rt_t::dijkstra;
+
+  // The cross-checks are submitted before the primary search, so
+  // that they run concurrently with it.
+  auto xb = m_xchecks.size();
+
+  if (m_xpool)
+    {
+      // The snapshot of the graph shared by the concurrent
+      // cross-checks.
+      shared_ptr<const graph> sg;
+
+      for(const auto ara: m_aras)
+        {
+          // There is no need to run the primary algorithm again.
+          if (ara == prt)
+            continue;
+
+          if (!sg)
+            sg = std::make_shared<const graph>(g);
+
+          auto f = m_xpool->submit([sg, d, cu, ara]
+                                   {
+                                     xcheck_worker = true;
+                                     return timed_search(*sg, d, cu, ara);
+                                   });
+
+          m_xchecks.push_back({d, cu, {}, ara, sg, std::move(f)});
+        }
     }
 
+  auto dr = search(g, d, cu, prt);
+
+  // The cross-checks submitted compare their results with this one.
+  for (auto i = m_xchecks.begin() + xb; i != m_xchecks.end(); ++i)
+    i->m_dr = dr;
+
+  if (!m_xpool)
+    for(const auto ara: m_aras)
+      if (ara != prt)
+        // Another result.
+        xcheck_compare(g, d, cu, dr, search(g, d, cu, ara), ara);
+
+  // Don't let the snapshots pile up.
+  if (m_xchecks.size() > max_xchecks)
+    xcheck_collect(true);
+
   if (dr)
     {
-      bool status = set_up_path(g, dr.value());
-      assert(status);
+      // The units could have been reserved concurrently.
+      if (!set_up_path(g, dr.value()))
+        dr.reset();
     }
+  else if (m_memo)
+    m_bm.blocked(d, cu, m_release_epoch);
 
   return dr;
 }
 
 optional<cupath>
 routing::search(graph &g, const demand &d, const CU &cu, rt_t rt)
+{
+  auto [p, dt] = timed_search(g, d, cu, rt);
+  report_perf(rt, p, dt, m_af);
+  return get<3>(p);
+}
+
+pair<routing::result, double>
+routing::timed_search(const graph &g, const demand &d, const CU &cu,
+                      rt_t rt)
 {
   using tp_t = chrono::time_point<chrono::high_resolution_clock>;
 
-  tuple<int, int, int, optional<cupath> > p;
+  result p;
 
   tp_t t0 = std::chrono::system_clock::now();
 
@@ -132,33 +289,81 @@ routing::search(graph &g, const demand &d, const CU &cu, rt_t rt)
   tp_t t1 = std::chrono::system_clock::now();
   chrono::duration<double> dt = t1 - t0;
 
-  stats::get().algo_perf(rt, dt.count(),
-                         get<0>(p), get<1>(p), get<2>(p));
+  return make_pair(std::move(p), dt.count());
+}
 
-  return get<3>(p);
+void
+routing::report_perf(rt_t rt, const result &r, double dt,
+                     const features &af)
+{
+  stats::get().algo_perf(rt, dt, get<0>(r), get<1>(r), get<2>(r));
+
+  // The auto mode learns from the time the algorithm took.
+  if (m_auto)
+    m_os.record(af, rt, dt);
 }
 
-template <typename Units>
-struct edge_has_units
+void
+routing::xcheck_compare(const graph &g, const demand &d, const CU &cu,
+                        const optional<cupath> &dr,
+                        const optional<cupath> &ar, rt_t ara)
 {
-  const graph *m_gp;
-  const Units *m_units;
+  if (!dr && !ar ||
+      dr && ar &&
+      dr.value().first.count() == ar.value().first.count() &&
+      get_cost(g, dr.value()) == get_cost(g, ar.value()))
+    return;
 
-  edge_has_units(): m_gp(0), m_units(0)
-  {
-  }
+  stats::get().xcheck_mismatch();
 
-  edge_has_units(const graph &g, const Units &units):
-    m_gp(&g), m_units(&units)
-  {
-  }
+  // The report of the mismatch with the spectrum state.
+  cerr << "xcheck mismatch:" << endl
+       << "  demand = " << d << endl
+       << "  cu = " << cu << endl
+       << "  algorithm = " << to_string(ara) << endl;
 
-  bool
-  operator () (const edge &e) const
-  {
-    return boost::get(boost::edge_su, *m_gp, e).includes(*m_units);
-  }
-};
+  cerr << "  dr = ";
+  if (dr)
+    cerr << dr.value() << ", cost = " << get_cost(g, dr.value());
+  else
+    cerr << "none";
+  cerr << endl;
+
+  cerr << "  ar = ";
+  if (ar)
+    cerr << ar.value() << ", cost = " << get_cost(g, ar.value());
+  else
+    cerr << "none";
+  cerr << endl;
+
+  for(const auto &e: make_iterator_range(edges(g)))
+    cerr << "  edge " << boost::source(e, g) << " "
+         << boost::target(e, g) << ": weight = "
+         << boost::get(boost::edge_weight, g, e) << ", su = "
+         << boost::get(boost::edge_su, g, e) << endl;
+}
+
+void
+routing::xcheck_collect(bool wait)
+{
+  // The results are compared in the order submitted, so that the
+  // reports are deterministic.
+  while (!m_xchecks.empty())
+    {
+      xcheck &x = m_xchecks.front();
+
+      if (!wait && x.m_f.wait_for(chrono::seconds(0)) !=
+          future_status::ready)
+        break;
+
+      auto [r, dt] = x.m_f.get();
+      // The time of the worker is not learned by the auto mode.
+      stats::get().algo_perf(x.m_ara, dt, get<0>(r), get<1>(r),
+                             get<2>(r));
+      xcheck_compare(*x.m_g, x.m_d, x.m_cu, x.m_dr, get<3>(r), x.m_ara);
+      m_xchecks.pop_front();
+    }
+}
 
 template <typename T>
 bool
@@ -277,15 +482,18 @@ is_optimal(const graph &g, vertex src, vertex dst, int ncu,
                           // Bingo! The costs must be the same,
                           // because the units are the same.  We found
                           // the same path with two algorithms.
-                          assert (gd_cost == fg_cost);
+                          if (gd_cost != fg_cost)
+                            return false;
                           ls.erase(li);
                         }
                       else
                         {
-                          if (gd_units.includes(fg_units))
-                            assert(gd_cost >= fg_cost);
-                          else if (fg_units.includes(gd_units))
-                            assert(fg_cost >= gd_cost);
+                          if (gd_units.includes(fg_units) &&
+                              gd_cost < fg_cost)
+                            return false;
+                          else if (fg_units.includes(gd_units) &&
+                                   fg_cost < gd_cost)
+                            return false;
 
                           ++li;
                         }
@@ -298,432 +506,1535 @@ is_optimal(const graph &g, vertex src, vertex dst, int ncu,
   return true;
 }
 
-tuple<int, int, int, optional<cupath> >
-routing::search_dijkstra(const graph &g, const demand &d,
-                         const CU &cu)
+// Sample the search, and check it in the background.  The check gets
+// the copies of the graph and the permanent solution, because the
+// search goes on with them.
+void
+verify(const graph &g, vertex src, vertex dst, int ncu, const CU &cu,
+       const generic_permanent<graph, COST, CU> &P)
 {
-  vertex src = d.first.first;
-  vertex dst = d.first.second;
-  // The number of contiguous units.
-  int ncu = d.second;
+  verifier *v = routing::get_verifier();
 
-  assert (src != dst);
+  // The sample is dropped before the copies are made.
+  if (v && v->sample() && v->try_reserve())
+    {
+      auto gc = std::make_shared<const graph>(g);
+      auto Pc = std::make_shared<generic_permanent<graph, COST, CU>>(P);
+
+      ostringstream what;
+      what << "src = " << src << ", dst = " << dst << ", ncu = " << ncu
+           << ", cu = " << cu;
+
+      v->submit([gc, Pc, src, dst, ncu]
+                {
+                  return is_consistent(*Pc) &&
+                    is_optimal(*gc, src, dst, ncu, *Pc);
+                }, what.str());
+    }
+}
+
+// Run the generic Dijkstra, and return the path found with the CU of
+// the label.  The search is run in graph g, which has super units of
+// k units each, and the labels of cost above ub are not created.  The
+// Model tells the units required, and the accountant finds the
+// maximal number of labels used.  If reached is given, the edges of
+// the permanent labels are set in it.
+template <typename Model, typename Accountant, typename Graph>
+optional<cupath>
+generic_dijkstra_search(const Graph &g, vertex src, vertex dst,
+                        int ncu, const CU &cu, int k, COST ub,
+                        Accountant &acc,
+                        boost::dynamic_bitset<> *reached = nullptr)
+{
+  // The checks know only the adaptive units in the graph.
+  constexpr bool checked = std::is_same_v<Model, adaptive_units<COST>> &&
+    std::is_same_v<Graph, graph>;
 
-  // The accountant type.
-  using acc_type = accountant<std::size_t>;
   // The generic permanent solution type.
-  using per_type = generic_permanent<graph, COST, CU>;
+  using per_type = generic_permanent<Graph, COST, CU>;
   // The generic tentative solution type.
-  using ten_type = generic_tentative<graph, COST, CU>;
+  using ten_type = generic_tentative<Graph, COST, CU>;
   // The accounted generic permanent solution type.
-  using acc_per_type = accounted_solution<per_type, acc_type>;
+  using acc_per_type = accounted_solution<per_type, Accountant>;
   // The accounted generic tentative solution type.
-  using acc_ten_type = accounted_solution<ten_type, acc_type>;
+  using acc_ten_type = accounted_solution<ten_type, Accountant>;
 
-  // The accountant finds the maximal number of labels used.
-  acc_type acc;
   // The permanent and tentative solutions.
   acc_per_type P(acc, boost::num_vertices(g));
   acc_ten_type T(acc, boost::num_vertices(g));
   // The label we start the search with.
-  generic_label<graph, COST, CU> l(0, CU(cu), edge(), src);
+  generic_label<Graph, COST, CU> l(0, CU(cu), edge(), src);
   // The creator of the labels.
-  generic_constrained_label_creator<graph, COST, CU> c(g, ncu);
+  generic_constrained_label_creator<Graph, COST, CU, Model> c(g, ncu, k,
+                                                             ub);
 
   // Run the search.
   dijkstra(g, l, P, T, c, dst);
 
+  // The edges of the permanent labels.  The label of src has no
+  // edge.
+  if (reached)
+    for (vertex v = 0; v < P.size(); ++v)
+      if (v != src)
+        for (const auto &pl: P[v])
+          reached->set(boost::get(boost::edge_index, g, get_edge(pl)));
+
   // The tracer.
-  generic_tracer<graph, cupath, acc_per_type, CU> t(g, ncu);
+  generic_tracer<Graph, cupath, acc_per_type, CU> t(g, ncu);
   // Get the path.
   auto op = trace(P, dst, l, t);
 
-  if (op)
-    {
-      // The length of the path found.
-      auto dist = get_path_length(g, op.value().second);
-      // The path CU.
-      auto &pcu = op.value().first;
-
-      // Get the number of units required.
-      int units = adaptive_units<COST>::units(ncu, dist);
-
-      // First-fit spectrum allocation policy.
-      pcu = CU(pcu.min(), pcu.min() + units);
-    }
+  // Check a sample of the searches in the background.  The check
+  // doesn't know about the super units.
+  if constexpr (checked)
+    if (k == 1 && !xcheck_worker)
+      verify(g, src, dst, ncu, cu, P);
 
   // Make sure that all the results in S and Q are consistent.
   assert(is_consistent(P));
   assert(is_consistent(T));
   // Make sure that all the results in S are optimal.  We're cleaning
-  // up S, but that's OK, because it's no longer needed.
-  assert(is_optimal(g, src, dst, ncu, P));
+  // up S, but that's OK, because it's no longer needed.  The check
+  // doesn't know about the super units.
+  if constexpr (checked)
+    assert(k != 1 || is_optimal(g, src, dst, ncu, P));
 
-  // The number of costs, the number of edges, and the number of CUs
-  // (units) equals to the number of labels, because a label has one
-  // cost, one edge, and one CU.  We assume a cost takes a single
-  // word, a label takes two words, and a CU takes two words.
-  return make_tuple(acc.m_max, 2 * acc.m_max, 2 * acc.m_max,
-                    std::move(op));
+  return op;
 }
 
-tuple<int, int, int, optional<cupath> >
-routing::search_parallel(const graph &g, const demand &d, const CU &cu)
+template <typename Model, typename Select>
+routing::result
+generic_search::operator()(const graph &g, const demand &d, const CU &cu,
+                           Select &select) const
 {
+  // Use the coarse-to-fine search if requested.  It knows only the
+  // adaptive units.
+  if constexpr (std::is_same_v<Model, adaptive_units<COST>>)
+    if (routing::m_cg && routing::m_cg->is_of(g))
+      return routing::search_c2f(g, d, cu, select);
+
   vertex src = d.first.first;
   vertex dst = d.first.second;
-  int min_units = d.second;
-
-  // The max of edges and costs.
-  std::size_t max_cae = 0;
+  // The number of contiguous units.
+  int ncu = d.second;
 
   assert (src != dst);
 
-  set<int> ncus = adaptive_units<COST>::ncus(min_units);
+  // The accountant type.
+  using acc_type = accountant<std::size_t>;
 
-  // Here we store the result.
-  optional<cupath> result;
+  // The accountant finds the maximal number of labels used.
+  acc_type acc;
+  // Run the search.
+  auto op = generic_dijkstra_search<Model>
+    (g, src, dst, ncu, cu, 1, std::numeric_limits<COST>::max(), acc);
 
-  // Candidate SUs.
-  for (int units: ncus)
+  if (op)
     {
-      // Get the candidate SUs (slots) with the given number of units.
-      auto slots = get_candidate_slots(cu, units);
-
-      // We have to go through all candidate SUs, because we don't
-      // know which shall yield the shortest path.
-      for (const CU &cu: slots)
-        {
-          edge_has_units<CU> ep(g, cu);
-
-          // The filtered graph type.
-          using fg_type = boost::filtered_graph<graph,
-                                                edge_has_units<CU> >;
-
-          // The filtered graph.
-          fg_type fg(g, ep);
-
-          // The accountant type.
-          using acc_type = accountant<std::size_t>;
-
-          // The standard permanent solution type.
-          using per_type = standard_permanent<fg_type, COST>;
-          // The standard tentative solution type.
-          using ten_type = standard_tentative<fg_type, COST>;
-          // The accounted standard permanent solution type.
-          using acc_per_type = accounted_solution<per_type, acc_type>;
-          // The accounted standard tentative solution type.
-          using acc_ten_type = accounted_solution<ten_type, acc_type>;
-
-          // Standard accountant.
-          acc_type acc;
-          acc_per_type P(acc, boost::num_vertices(fg));
-          acc_ten_type T(acc, boost::num_vertices(fg));
-
-          // The label we start the search with.
-          standard_label<fg_type, COST> l(0, edge(), src);
-          // The reach of that modulation.
-          COST r = adaptive_units<COST>::reach(min_units, units);
-          // The object that creates labels.
-          standard_constrained_label_creator<fg_type, COST> c(fg, r);
-          // Start the search.
-          dijkstra(fg, l, P, T, c, dst);
-          // The standard tracer.
-          standard_tracer<fg_type, acc_per_type, path> t(fg);
-          auto op = trace(P, dst, l, t);
-
-          if (op && (!result ||
-                     get_path_length(g, op.value()) <
-                     get_path_length(g, result.value().second)))
-            result = cupath(cu, op.value());
-
-          if (max_cae < acc.m_max)
-            max_cae = acc.m_max;
-        }
-
-      // If result found, stop searching for the next number of units.
-      if (result)
-        break;
+      // The length of the path found.
+      auto dist = get_path_length(g, op.value().second);
+      // Get the number of units required.
+      int units = Model::units(ncu, dist);
+      // Select the units.
+      routing::select_units(g, cu, units, op.value(), select);
     }
 
-  // The number of costs and the number of edges equals to the number
-  // of labels, because a label has one edge and one cost.  Every
-  // search in iteratios above takes a single CU.  We assume a cost
-  // takes a single word, a label takes two words, and a CU takes two
-  // words.
-  return make_tuple(max_cae, 2 * max_cae, 2, result);
+  // The number of costs, the number of edges, and the number of CUs
+  // (units) equals to the number of labels, because a label has one
+  // cost, one edge, and one CU.  We assume a cost takes a single
+  // word, a label takes two words, and a CU takes two words.
+  return make_tuple(acc.m_max, 2 * acc.m_max, 2 * acc.m_max,
+                    std::move(op));
 }
 
-// The adaptor class which keeps track of the max number of costs,
-// edges and units stored in the priority queue.
-template<typename T, typename C, typename F>
-class my_priority_queue
+const vector<COST> &
+routing::distances(const graph &g, vertex v)
 {
-  using qt = std::priority_queue<T, C, F>;
+  if (m_dc && m_dc->is_of(g))
+    return m_dc->from(v);
 
-  // The queue.
-  qt Q;
-  
-  // The number of costs to store.
-  int costs = 0;
-  // The number of edges to store.
-  int edges = 0;
-  // The number of units to store.
-  int units = 0;
+  static thread_local vector<COST> dist;
+  dist.resize(num_vertices(g));
+  boost::dijkstra_shortest_paths(g, v, boost::distance_map(&dist[0]));
 
-public:
-  // The number of costs to store.
-  int max_costs = 0;
-  // The number of edges to store.
-  int max_edges = 0;
-  // The number of units to store.
-  int max_units = 0;
+  return dist;
+}
 
-  typename qt::const_reference top() const
-  {
-    return Q.top();
-  }
+// The edge predicate of a filtered graph: true if the edge has at
+// least ncu contiguous units available within the given CU.  A path
+// with the ncu units has only such edges.
+struct edge_fits
+{
+  const graph *m_gp;
+  CU m_cu;
+  int m_ncu;
 
-  void push(T &&q)
+  edge_fits(): m_gp(0), m_ncu(0)
   {
-    // There is a single cost for every path pushed.
-    ++costs;
-    // Increase by the number of edges of the path pushed.
-    edges += get<1>(q).first.size();
-    // Increase by the number of units of the path pushed.
-    units += get<1>(q).second.size();
-    // Push the element as the r-value to Q.
-    Q.push(std::move(q));
-
-    if (max_costs + max_edges + max_units < costs + edges + units)
-      {
-        max_costs = costs;
-        max_edges = edges;
-        max_units = units;
-      }
   }
 
-  void pop()
+  edge_fits(const graph &g, const CU &cu, int ncu):
+    m_gp(&g), m_cu(cu), m_ncu(ncu)
   {
-    // This is the element we are about to pop.
-    auto const &q = Q.top();
-    // There is a single cost for every path poped.
-    --costs;
-    // Decrease by the number of edges of the path poped.
-    edges -= get<1>(q).first.size();
-    // Decrease by the number of units of the path poped.
-    units -= get<1>(q).second.size();
-    // Pop the element.
-    Q.pop();
   }
 
-  bool empty()
+  bool
+  operator () (const edge &e) const
   {
-    return Q.empty();
+    for (const auto &f: boost::get(boost::edge_su, *m_gp, e))
+      {
+        auto min = std::max(f.min(), m_cu.min());
+        auto max = std::min(f.max(), m_cu.max());
+        if (min < max && max - min >= unsigned(m_ncu))
+          return true;
+      }
+
+    return false;
   }
 };
 
-// The SU path.
-typedef std::pair<SU, path> supath;
+// The length of the shortest path from src to dst over the edges that
+// fit ncu units within cu, or the max if there is no such path.  No
+// path with the units is shorter, and so it's a lower bound tighter
+// than the shortest distance.
+static COST
+fitting_distance(const graph &g, vertex src, vertex dst, const CU &cu,
+                 int ncu)
+{
+  boost::filtered_graph<graph, edge_fits> fg(g, edge_fits(g, cu, ncu));
+  static thread_local vector<COST> dist;
+  dist.resize(num_vertices(g));
+  boost::dijkstra_shortest_paths(fg, src, boost::distance_map(&dist[0]));
 
-// This is the implementation of the algorithm from "Dynamic Routing
-// and Spectrum Assignment in Spectrum-Flexible Transparent Optical
-// Networks".  A path in the priority queue has its SU.
+  return dist[dst];
+}
+
+template <typename Select>
 tuple<int, int, int, optional<cupath> >
-routing::search_brtforce(const graph &g, const demand &d, const CU &cu)
+routing::search_c2f(const graph &g, const demand &d, const CU &cu,
+                    Select &select)
 {
-  // This is the result.
-  optional<cupath> result;
-
   vertex src = d.first.first;
   vertex dst = d.first.second;
   // The number of contiguous units.
   int ncu = d.second;
+  // The coarse graph, and the number of units in a super unit.
+  const graph &cg = m_cg->get();
+  int k = m_cg->k();
 
   assert (src != dst);
 
-  using ew = boost::edge_weight_t;
-  using wt = boost::property_map<graph, ew>::value_type;
-  // The queue element has to store the destination vertex too,
-  // because for the primer element, we will not be able to figure out
-  // the vertex from the empty supath.
-  using qe = std::tuple<wt, supath, vertex>;
+  // The accountant type.
+  using acc_type = accountant<std::size_t>;
 
-  // This is the priority queue.
-  // std::priority_queue<qe, std::vector<qe>, std::greater<qe> > Q;
-  my_priority_queue<qe, std::vector<qe>, std::greater<qe> > Q;
+  // The shortest distance is the lower bound.
+  COST sd = distances(g, src)[dst];
+
+  // The coarse pass.  A coarse path is a feasible path in the
+  // original graph, and so its length is the upper bound.  The edges
+  // reached by the coarse pass are the corridor of the fine pass.
+  acc_type cacc;
+  optional<path> cp;
+  boost::dynamic_bitset<> corridor(num_edges(g));
+  if (CU ccu = coarsen(cu, k))
+    if (auto op = generic_dijkstra_search<adaptive_units<COST>>
+        (cg, src, dst, ncu, ccu, k, std::numeric_limits<COST>::max(),
+         cacc, &corridor))
+      {
+        cp = path();
+        for (const auto &e: op.value().second)
+          cp.value().push_back(m_cg->fine(e));
+      }
 
-  // Insert the primer.
-  Q.push(make_tuple(0, supath(SU{cu}, {}), src));
+  // The upper bound of the coarse path, if found.
+  COST ub = cp ? get_path_length(g, cp.value())
+    : std::numeric_limits<COST>::max();
 
-  while (!Q.empty())
+  // The lower bound.  If the coarse path is longer than the shortest
+  // distance, we tighten the bound with the edges that fit the units,
+  // which costs a single Dijkstra search with no labels.
+  COST lb = sd;
+  if (lb < ub)
+    lb = fitting_distance(g, src, dst, cu, ncu);
+
+  // The result.
+  optional<cupath> result;
+
+  // The number of passes run: the coarse, the corridor, and the full.
+  int passes = 1;
+
+  // The fine pass, which refines the corridor, and then searches the
+  // whole graph.
+  acc_type racc, facc;
+  if (cp && ub <= lb)
     {
-      auto q = Q.top();
-      Q.pop();
-      wt c = get<0>(q);
-      const supath &p = get<1>(q);
-      vertex v = get<2>(q);
+      // The upper bound is tight: no path is shorter than the lower
+      // bound, and so we skip the fine pass.  The path SU is sure to
+      // have the units required.
+      int units = adaptive_units<COST>::units(ncu, ub);
+      auto ecu = select_path_cu(g, cp.value(), cu, units, select);
+      assert(ecu);
+      result = cupath(ecu.value(), std::move(cp.value()));
+    }
+  else if (lb != std::numeric_limits<COST>::max())
+    {
+      if (cp)
+        {
+          // Refine the corridor.  The coarse path is in the corridor,
+          // and so a path is found.
+          ++passes;
+          boost::filtered_graph<graph, edge_in_set>
+            fg(g, edge_in_set(g, corridor));
+          result = generic_dijkstra_search<adaptive_units<COST>>
+            (fg, src, dst, ncu, cu, 1, ub, racc);
+          assert(result);
+          ub = get_path_length(g, result.value().second);
+        }
 
-      if (v == dst)
+      // A shorter path can be out of the corridor, unless the path
+      // refined is as short as the lower bound.
+      if (!result || lb < ub)
         {
-          int units = adaptive_units<COST>::units(ncu, c);
-          // The selected CU.
-          CU cu = select_cu(p.first, units);
-          result = cupath(cu, p.second);
-          break;
+          ++passes;
+          result = generic_dijkstra_search<adaptive_units<COST>>
+            (g, src, dst, ncu, cu, 1, ub, facc);
         }
 
-      for(const auto &e: make_iterator_range(out_edges(v, g)))
+      if (result)
         {
-          // The target vertex of edge e.
-          vertex t = boost::target(e, g);
+          // The length of the path found.
+          auto dist = get_path_length(g, result.value().second);
+          // Get the number of units required.
+          int units = adaptive_units<COST>::units(ncu, dist);
+          // Select the units.
+          select_units(g, cu, units, result.value(), select);
+        }
+    }
 
-          // We don't allow for loops.
-          if (!vertex_in_path(g, p.second, t))
-            {
-              // The edge SU.
-              const SU &e_su = boost::get(boost::edge_su, g, e);
-              // The path SU.
-              const SU &p_su = p.first;
-              // The edge cost.
-              wt ec = boost::get(boost::edge_weight, g, e);
+  // The fine passes run one after another, and so do the coarse and
+  // the fine passes, so we report the larger numbers of labels.
+  auto fine = std::max(racc.m_max, facc.m_max);
+
+  if (!xcheck_worker)
+    stats::get().c2f_perf(cacc.m_max, fine, passes);
+
+  // The labels are accounted as in search_dijkstra.
+  auto labels = std::max(cacc.m_max, fine);
+  return make_tuple(labels, 2 * labels, 2 * labels, std::move(result));
+}
+
+// Search for the shortest path in graph g filtered with the edge
+// predicate to the edges that have the units of a slot, and within
+// the reach r of the modulation of the slot.  The accountant finds the
+// maximal number of labels used.
+template <typename Accountant, typename Predicate>
+optional<path>
+filtered_search(const graph &g, vertex src, vertex dst, COST r,
+                const Predicate &ep, Accountant &acc, COST ub)
+{
+  // The filtered graph type.
+  using fg_type = boost::filtered_graph<graph, Predicate>;
+
+  // The filtered graph.
+  fg_type fg(g, ep);
+
+  // The standard permanent solution type.
+  using per_type = standard_permanent<fg_type, COST>;
+  // The standard tentative solution type.
+  using ten_type = standard_tentative<fg_type, COST>;
+  // The accounted standard permanent solution type.
+  using acc_per_type = accounted_solution<per_type, Accountant>;
+  // The accounted standard tentative solution type.
+  using acc_ten_type = accounted_solution<ten_type, Accountant>;
+
+  acc_per_type P(acc, boost::num_vertices(fg));
+  acc_ten_type T(acc, boost::num_vertices(fg));
+
+  // The label we start the search with.
+  standard_label<fg_type, COST> l(0, edge(), src);
+  // The object that creates labels.  The labels are not longer than
+  // the upper bound, so that the search stops early.
+  standard_constrained_label_creator<fg_type, COST> c(fg, std::min(r, ub));
+  // Start the search.
+  dijkstra(fg, l, P, T, c, dst);
+  // The standard tracer.
+  standard_tracer<fg_type, acc_per_type, path> t(fg);
+  return trace(P, dst, l, t);
+}
+
+// Search for the shortest path within the reach r along the edges of
+// the set of a slot of the slot edges se.  Only the out edges in the
+// set are visited, and so the edges without the slot cost nothing.
+// The accountant finds the maximal number of labels used.
+template <typename Accountant>
+optional<path>
+set_search(const graph &g, vertex src, vertex dst, COST r,
+           const slot_edges &se, const boost::dynamic_bitset<> &set,
+           Accountant &acc, COST ub)
+{
+  // The labels are not longer than the bound.
+  COST bound = std::min(r, ub);
+
+  // The costs and the last edges of the labels of the vertices, and
+  // whether the labels are permanent.
+  vector<COST> costs(num_vertices(g), std::numeric_limits<COST>::max());
+  vector<edge> last(num_vertices(g));
+  vector<bool> permanent(num_vertices(g));
+
+  // The queue of the tentative labels.
+  using qe = pair<COST, vertex>;
+  std::priority_queue<qe, vector<qe>, std::greater<qe>> Q;
+
+  costs[src] = 0;
+  ++acc;
+  Q.push(qe(0, src));
+
+  while (!Q.empty())
+    {
+      auto [c, v] = Q.top();
+      Q.pop();
+
+      // The label was replaced with a shorter one.
+      if (permanent[v])
+        continue;
+
+      permanent[v] = true;
+
+      if (v == dst)
+        {
+          path p;
+          for (vertex u = dst; u != src; u = boost::source(last[u], g))
+            p.push_front(last[u]);
+          return p;
+        }
+
+      se.for_each_out_edge(set, v, [&, c = c](const edge &e)
+                           {
+                             vertex t = boost::target(e, g);
+                             COST cc = c + boost::get(boost::edge_weight,
+                                                      g, e);
+
+                             if (cc <= bound && cc < costs[t])
+                               {
+                                 if (costs[t] ==
+                                     std::numeric_limits<COST>::max())
+                                   ++acc;
+                                 costs[t] = cc;
+                                 last[t] = e;
+                                 Q.push(qe(cc, t));
+                               }
+                           });
+    }
+
+  return {};
+}
+
+// Search for the shortest path with the slot within the reach r.  If
+// the set of the edges with the slot is given, only the edges of the
+// set are visited, and otherwise the edges are filtered with their
+// SUs.
+template <typename Accountant>
+optional<path>
+slot_search(const graph &g, vertex src, vertex dst, COST r,
+            const CU &slot, const slot_edges *se,
+            const boost::dynamic_bitset<> *set, Accountant &acc,
+            COST ub = std::numeric_limits<COST>::max())
+{
+  if (set)
+    return set_search(g, src, dst, r, *se, *set, acc, ub);
+
+  return filtered_search(g, src, dst, r, edge_has_units<CU>(g, slot),
+                         acc, ub);
+}
+
+// The sets of the edges with the slots, indexed as the slots, and the
+// slot edges they are of.  The sets are empty if not used.
+struct slot_sets
+{
+  const slot_edges *m_se = nullptr;
+  vector<const boost::dynamic_bitset<> *> m_sets;
+};
+
+// The set of the edges with the i-th slot, or nullptr if not used.
+static const boost::dynamic_bitset<> *
+slot_set(const slot_sets &sets, std::size_t i)
+{
+  return sets.m_sets.empty() ? nullptr : sets.m_sets[i];
+}
+
+// The best result of the slots searched by a thread: the index of the
+// slot, and the path found.  The max_cae is the max of edges and
+// costs of the searches.
+struct slots_result
+{
+  optional<pair<std::size_t, path>> m_best;
+  std::size_t m_max_cae = 0;
+};
+
+// Search the slots with indexes [first, last) within the reach r of
+// their modulation.  The best path is the shortest, and of the
+// shortest, the one of the lowest index.
+static slots_result
+slots_search(const graph &g, vertex src, vertex dst, COST r,
+             const vector<CU> &slots, const slot_sets &sets,
+             std::size_t first, std::size_t last)
+{
+  slots_result result;
+
+  for (std::size_t i = first; i < last; ++i)
+    {
+      // The accountant type.
+      using acc_type = accountant<std::size_t>;
+      // Standard accountant.
+      acc_type acc;
+
+      auto op = slot_search(g, src, dst, r, slots[i], sets.m_se,
+                            slot_set(sets, i), acc);
+
+      if (op && (!result.m_best ||
+                 get_path_length(g, op.value()) <
+                 get_path_length(g, result.m_best.value().second)))
+        result.m_best = make_pair(i, std::move(op.value()));
+
+      result.m_max_cae = std::max(result.m_max_cae, acc.m_max);
+    }
+
+  return result;
+}
+
+// The lower bound on the length of a path with the slot: the path has
+// to leave src along an edge with the slot, and then it's at least as
+// long as the shortest path.  The bound is infinite if no edge of src
+// has the slot, which is the case when the edges near src are
+// occupied.
+static COST
+slot_lower_bound(const graph &g, vertex src, const CU &slot,
+                 const vector<COST> &dist)
+{
+  COST lb = std::numeric_limits<COST>::max();
+
+  for(const auto &e: make_iterator_range(out_edges(src, g)))
+    if (boost::get(boost::edge_su, g, e).includes(slot))
+      lb = std::min(lb, boost::get(boost::edge_weight, g, e) +
+                    dist[boost::target(e, g)]);
+
+  return lb;
+}
+
+// Search the slots by branch and bound.  The slots are searched in
+// the order of their lower bounds, and the slots whose lower bounds
+// are no better than the best path found are pruned.  The result is
+// the same as of slots_search: the shortest path, and of the shortest,
+// the one of the lowest slot index.  The slots are within the reach r
+// of their modulation.  The dist are the shortest distances to dst.
+// The number of pruned slots is added to pruned.
+static slots_result
+slots_bnb(const graph &g, vertex src, vertex dst, COST r,
+          const vector<CU> &slots, const slot_sets &sets,
+          const vector<COST> &dist, std::size_t &pruned)
+{
+  slots_result result;
+
+  // The lower bounds and the indexes of the slots, sorted.
+  vector<pair<COST, std::size_t>> order;
+  for (std::size_t i = 0; i < slots.size(); ++i)
+    order.emplace_back(slot_lower_bound(g, src, slots[i], dist), i);
+  sort(order.begin(), order.end());
+
+  // The length of the best path.
+  COST best = std::numeric_limits<COST>::max();
+
+  for (const auto &[lb, i]: order)
+    {
+      // The slot can't yield a path within the reach, or no edge of
+      // src has the slot.
+      if (r < lb || lb == std::numeric_limits<COST>::max())
+        {
+          ++pruned;
+          continue;
+        }
+
+      if (result.m_best)
+        {
+          // The remaining slots have no shorter paths.
+          if (best < lb)
+            {
+              ++pruned;
+              continue;
+            }
+
+          // The slot can only tie with the best path, and it loses,
+          // because of the higher index.
+          if (lb == best && result.m_best.value().first < i)
+            {
+              ++pruned;
+              continue;
+            }
+        }
+
+      // The accountant type.
+      using acc_type = accountant<std::size_t>;
+      // Standard accountant.
+      acc_type acc;
+
+      auto op = slot_search(g, src, dst, r, slots[i], sets.m_se,
+                            slot_set(sets, i), acc, best);
+
+      if (op)
+        {
+          COST len = get_path_length(g, op.value());
+
+          if (!result.m_best || len < best ||
+              (len == best && i < result.m_best.value().first))
+            {
+              best = len;
+              result.m_best = make_pair(i, std::move(op.value()));
+            }
+        }
+
+      result.m_max_cae = std::max(result.m_max_cae, acc.m_max);
+    }
+
+  return result;
+}
+
+template <typename Model, typename Select>
+routing::result
+parallel_search::operator()(const graph &g, const demand &d, const CU &cu,
+                            Select &select) const
+{
+  vertex src = d.first.first;
+  vertex dst = d.first.second;
+  int min_units = d.second;
+
+  // The max of edges and costs.
+  std::size_t max_cae = 0;
+
+  assert (src != dst);
+
+  set<int> ncus = Model::ncus(min_units);
+
+  // Here we store the result.
+  optional<cupath> result;
+
+  // The numbers of slots, and of the slots pruned by branch and bound.
+  std::size_t nslots = 0, pruned = 0;
+
+  // Candidate SUs.
+  for (int units: ncus)
+    {
+      // Get the candidate SUs (slots) with the given number of units.
+      auto cs = get_candidate_slots(cu, units);
+      nslots += cs.size();
+      vector<CU> slots(cs.begin(), cs.end());
+      // The reach of that modulation.
+      COST r = Model::reach(min_units, units);
+
+      // The sets of the edges with the slots, if they are of this
+      // graph, and not of its snapshot.
+      slot_sets sets;
+      if (routing::m_se && routing::m_se->is_of(g))
+        {
+          sets.m_se = routing::m_se.get();
+          for (const auto &slot: slots)
+            sets.m_sets.push_back(&routing::m_se->get(slot));
+        }
+
+      // We have to go through all candidate SUs, because we don't
+      // know which shall yield the shortest path.
+      slots_result sr;
+
+      if (routing::m_bnb)
+        // The graph is undirected, so the distances from dst are the
+        // distances to dst.
+        sr = slots_bnb(g, src, dst, r, slots, sets,
+                       routing::distances(g, dst), pruned);
+      else if (routing::m_ppool && slots.size() > 1)
+        {
+          // The slots are split into contiguous chunks, one per
+          // thread, and the results of the chunks are merged in the
+          // order of the slots, so that the ties are broken as in
+          // the serial loop.
+          std::size_t n = std::min<std::size_t>(routing::m_ppool->size(),
+                                                slots.size());
+          vector<future<slots_result>> fs;
+
+          for (std::size_t i = 0; i < n; ++i)
+            {
+              std::size_t first = slots.size() * i / n;
+              std::size_t last = slots.size() * (i + 1) / n;
+              fs.push_back(routing::m_ppool->submit
+                           ([&g, src, dst, r, &slots, &sets, first,
+                             last]
+                            {
+                              return slots_search(g, src, dst, r, slots,
+                                                  sets, first, last);
+                            }));
+            }
+
+          for (auto &f: fs)
+            {
+              slots_result cr = f.get();
+
+              if (cr.m_best &&
+                  (!sr.m_best ||
+                   get_path_length(g, cr.m_best.value().second) <
+                   get_path_length(g, sr.m_best.value().second)))
+                sr.m_best = std::move(cr.m_best);
+
+              sr.m_max_cae = std::max(sr.m_max_cae, cr.m_max_cae);
+            }
+        }
+      else
+        sr = slots_search(g, src, dst, r, slots, sets, 0, slots.size());
+
+      max_cae = std::max(max_cae, sr.m_max_cae);
+
+      // If result found, stop searching for the next number of units.
+      if (sr.m_best)
+        {
+          auto &[i, p] = sr.m_best.value();
+          result = cupath(slots[i], std::move(p));
+          // The slot is the first fit, so select the units of the
+          // path with the selection policy.
+          routing::select_units(g, cu, units, result.value(), select);
+          break;
+        }
+    }
+
+  if (routing::m_bnb && !xcheck_worker)
+    stats::get().bnb_perf(nslots, pruned);
+
+  // The number of costs and the number of edges equals to the number
+  // of labels, because a label has one edge and one cost.  Every
+  // search in iteratios above takes a single CU.  We assume a cost
+  // takes a single word, a label takes two words, and a CU takes two
+  // words.
+  return make_tuple(max_cae, 2 * max_cae, 2, result);
+}
+
+// The adaptor class which keeps track of the max number of costs,
+// edges and units stored in the priority queue.  The measure tells
+// the numbers of edges and units of an element.
+template<typename T, typename C, typename F, typename M>
+class my_priority_queue
+{
+  using qt = std::priority_queue<T, C, F>;
+
+  // The queue.
+  qt Q;
+
+  // The measure of the elements.
+  M m_measure;
+  
+  // The number of costs to store.
+  int costs = 0;
+  // The number of edges to store.
+  int edges = 0;
+  // The number of units to store.
+  int units = 0;
+
+public:
+  // The number of costs to store.
+  int max_costs = 0;
+  // The number of edges to store.
+  int max_edges = 0;
+  // The number of units to store.
+  int max_units = 0;
+
+  my_priority_queue(M measure): m_measure(measure)
+  {
+  }
+
+  typename qt::const_reference top() const
+  {
+    return Q.top();
+  }
+
+  void push(T &&q)
+  {
+    auto [e, u] = m_measure(q);
+    // There is a single cost for every path pushed.
+    ++costs;
+    // Increase by the number of edges of the path pushed.
+    edges += e;
+    // Increase by the number of units of the path pushed.
+    units += u;
+    // Push the element as the r-value to Q.
+    Q.push(std::move(q));
+
+    if (max_costs + max_edges + max_units < costs + edges + units)
+      {
+        max_costs = costs;
+        max_edges = edges;
+        max_units = units;
+      }
+  }
+
+  void pop()
+  {
+    // This is the element we are about to pop.
+    auto [e, u] = m_measure(Q.top());
+    // There is a single cost for every path poped.
+    --costs;
+    // Decrease by the number of edges of the path poped.
+    edges -= e;
+    // Decrease by the number of units of the path poped.
+    units -= u;
+    // Pop the element.
+    Q.pop();
+  }
+
+  bool empty()
+  {
+    return Q.empty();
+  }
+};
+
+// The node of a path in the arena of the brute force.  A path is
+// stored as its last edge and the index of the node of the path
+// without that edge.
+struct bf_node
+{
+  // The index of the parent node.  The root node is its own parent.
+  std::size_t m_parent;
+  // The last edge of the path, undefined for the root node.
+  edge m_e;
+  // The vertex the path ends at.
+  vertex m_v;
+  // The number of edges of the path.
+  int m_length;
+  // The handle of the SU and of the visited vertices of the path,
+  // valid while the node is queued.
+  std::size_t m_su;
+  // The number of the children of the node, plus one if it's queued.
+  int m_refs;
+};
+
+// The arena of the path nodes, and of their SUs and visited vertices
+// under the same handle.  The SU and the visited vertices of a node
+// are freed when the node is expanded, and the node is freed when
+// it's neither queued nor a parent.  The nodes and the handles freed
+// are reused, and so are the bitsets of the visited vertices.
+struct bf_arena
+{
+  vector<bf_node> m_nodes;
+  vector<std::size_t> m_free_nodes;
+  vector<SU> m_sus;
+  vector<boost::dynamic_bitset<>> m_visited;
+  vector<std::size_t> m_free_sus;
+
+  // The number of the vertices of the graph.
+  std::size_t m_nv;
+
+  explicit bf_arena(std::size_t nv): m_nv(nv)
+  {
+  }
+
+  // Add the node, and return its index.
+  std::size_t
+  add(const bf_node &n)
+  {
+    if (m_free_nodes.empty())
+      {
+        m_nodes.push_back(n);
+        return m_nodes.size() - 1;
+      }
+
+    std::size_t i = m_free_nodes.back();
+    m_free_nodes.pop_back();
+    m_nodes[i] = n;
+    return i;
+  }
+
+  // Add the SU of the path that visits vertex v, and return its
+  // handle.  The path also visits the vertices of the path of handle
+  // p, if given.
+  std::size_t
+  add_su(SU &&su, vertex v, optional<std::size_t> p = {})
+  {
+    std::size_t h;
+
+    if (m_free_sus.empty())
+      {
+        h = m_sus.size();
+        m_sus.push_back(std::move(su));
+        m_visited.emplace_back(m_nv);
+      }
+    else
+      {
+        h = m_free_sus.back();
+        m_free_sus.pop_back();
+        m_sus[h] = std::move(su);
+      }
+
+    // The bitset of the same size is assigned without allocation.
+    if (p)
+      m_visited[h] = m_visited[p.value()];
+    else
+      m_visited[h].reset();
+    m_visited[h].set(v);
+
+    return h;
+  }
+
+  void
+  free_su(std::size_t h)
+  {
+    m_sus[h] = SU();
+    m_free_sus.push_back(h);
+  }
+
+  // Drop a reference to node i, and free the nodes without the
+  // references up the chain of the parents.
+  void
+  unref(std::size_t i)
+  {
+    while (!--m_nodes[i].m_refs)
+      {
+        m_free_nodes.push_back(i);
+        if (!m_nodes[i].m_length)
+          break;
+        i = m_nodes[i].m_parent;
+      }
+  }
+
+  // True if the path of node i visits vertex v, which is the loop
+  // check.  The node has to be queued.
+  bool
+  visits(std::size_t i, vertex v) const
+  {
+    return m_visited[m_nodes[i].m_su].test(v);
+  }
+
+  // The path of node i.
+  path
+  get_path(std::size_t i) const
+  {
+    path p;
+
+    for (; m_nodes[i].m_length; i = m_nodes[i].m_parent)
+      p.push_front(m_nodes[i].m_e);
+
+    return p;
+  }
+};
+
+// This is the implementation of the algorithm from "Dynamic Routing
+// and Spectrum Assignment in Spectrum-Flexible Transparent Optical
+// Networks".  A path in the priority queue has its SU.  The paths are
+// nodes in an arena, so that a path isn't copied when extended.
+tuple<int, int, int, optional<cupath> >
+routing::search_brtforce(const graph &g, const demand &d, const CU &cu)
+{
+  // This is the result.
+  optional<cupath> result;
+
+  vertex src = d.first.first;
+  vertex dst = d.first.second;
+  // The number of contiguous units.
+  int ncu = d.second;
+
+  assert (src != dst);
+
+  using ew = boost::edge_weight_t;
+  using wt = boost::property_map<graph, ew>::value_type;
+  // The queue element: the cost, the number of the elements pushed
+  // before, and the index of the path node.  The elements of the same
+  // cost are popped in the order pushed, even though the indexes of
+  // the nodes are reused.
+  using qe = std::tuple<wt, std::size_t, std::size_t>;
+
+  // The arena of the path nodes.
+  bf_arena arena(num_vertices(g));
+
+  // The number of the elements pushed.
+  std::size_t pushed = 0;
+
+  // The measure of a queue element, as if it stored its SU and path.
+  auto measure = [&arena](const qe &q)
+                 {
+                   const bf_node &n = arena.m_nodes[get<2>(q)];
+                   return make_pair(int(arena.m_sus[n.m_su].size()),
+                                    n.m_length);
+                 };
+
+  // This is the priority queue.
+  my_priority_queue<qe, std::vector<qe>, std::greater<qe>,
+                    decltype(measure)> Q(measure);
+
+  // Insert the primer.
+  arena.add({0, edge(), src, 0, arena.add_su(SU{cu}, src), 1});
+  Q.push(qe(0, pushed++, 0));
+
+  while (!Q.empty())
+    {
+      auto [c, n, i] = Q.top();
+      Q.pop();
+      vertex v = arena.m_nodes[i].m_v;
+      // The SU of the path.
+      std::size_t h = arena.m_nodes[i].m_su;
+
+      if (v == dst)
+        {
+          int units = adaptive_units<COST>::units(ncu, c);
+          // The selected CU.
+          CU cu = select_cu(arena.m_sus[h], units);
+          result = cupath(cu, arena.get_path(i));
+          break;
+        }
+
+      for(const auto &e: make_iterator_range(out_edges(v, g)))
+        {
+          // The target vertex of edge e.
+          vertex t = boost::target(e, g);
+
+          // We don't allow for loops.
+          if (!arena.visits(i, t))
+            {
+              // The edge SU.
+              const SU &e_su = boost::get(boost::edge_su, g, e);
+              // The edge cost.
+              wt ec = boost::get(boost::edge_weight, g, e);
               // The candidate cost.
               auto cc = c + ec;
               // The candidate SU.
-              SU c_su = intersection(p_su, e_su);
+              SU c_su = intersection(arena.m_sus[h], e_su);
               c_su.remove(adaptive_units<COST>::units(ncu, cc));
               if (!c_su.empty())
                 {
                   // The candidate path.
-                  supath cp = supath(std::move(c_su), p.second);
-                  cp.second.push_back(e);
-                  Q.push(make_tuple(cc, std::move(cp), t));
+                  int length = arena.m_nodes[i].m_length + 1;
+                  std::size_t ch = arena.add_su(std::move(c_su), t, h);
+                  std::size_t j = arena.add({i, e, t, length, ch, 1});
+                  ++arena.m_nodes[i].m_refs;
+                  Q.push(qe(cc, pushed++, j));
                 }
             }
         }
+
+      // The path was expanded, and its SU isn't needed anymore.
+      arena.free_su(h);
+      arena.unref(i);
+    }
+
+  // We assume a cost takes a single word, a label takes two words,
+  // and a CU takes two words.
+  return make_tuple(Q.max_costs, 2 * Q.max_edges, 2 * Q.max_units,
+                    result);
+}
+
+tuple<int, int, int, optional<cupath> >
+routing::search_puyenksp(const graph &g, const demand &d, const CU &cu)
+{
+  vertex src = d.first.first;
+  vertex dst = d.first.second;
+  // The number of contiguous units.
+  int ncu = d.second;
+
+  assert (src != dst);
+
+  // Use the library of the paths, if it's of this graph, and not of
+  // its snapshot.
+  if (m_kl && m_kl->is_of(g))
+    return search_ksp_library(g, d, cu);
+
+  using ew = boost::edge_weight_t;
+  using wt = boost::property_map<graph, ew>::value_type;
+  using kr_type = boost::Result<wt, graph>;
+
+  // The shortest paths - these we return.
+  std::list<kr_type> A;
+  std::set<kr_type> B;
+
+  // Compute the spur paths in the threads, if there are any.
+  auto pf = [](std::size_t n, const auto &f)
+            {
+              m_ypool->parallel_for(n, f);
+            };
+
+  // The workspace of the Dijkstra searches of the thread, reused by
+  // the demands.
+  static thread_local boost::dijkstra_workspace<graph, COST> ws;
+
+  auto wm = get(boost::edge_weight_t(), g);
+  auto im = get(boost::vertex_index_t(), g);
+
+  // The reverse shortest path tree rooted at dst, if used.
+  using tree_type = boost::yen_tree<graph, decltype(wm), decltype(im)>;
+  optional<tree_type> tree;
+  if (m_yen_tree)
+    tree.emplace(g, dst, wm, im);
+
+  // The root with the spectrum, if the spur paths are pruned.
+  spectrum_root<> root(g, cu, ncu);
+
+  // The Eppstein algorithm, if used in place of the Yen algorithm.
+  using ep_type = boost::eppstein_ksp<graph, decltype(wm), decltype(im)>;
+  optional<ep_type> ep;
+  if (m_eppstein)
+    ep.emplace(g, src, dst, wm, im);
+
+  // Find the next shortest path.
+  auto next = [&]
+              {
+                if (ep)
+                  {
+                    auto r = ep.value()();
+                    if (r)
+                      A.push_back(std::move(r.value()));
+                    return bool(r);
+                  }
+                if (m_yen_su)
+                  return yen_ksp(g, src, dst, wm, im, A, B, ws, root);
+                if (tree)
+                  return yen_ksp(g, src, dst, wm, im, A, B, tree.value());
+                if (m_ypool)
+                  return yen_ksp(g, src, dst, wm, im, A, B, pf);
+                return yen_ksp(g, src, dst, wm, im, A, B, ws);
+              };
+
+  // Report the Dijkstra searches saved by the tree or the root.
+  auto report = [&]
+                {
+                  if (xcheck_worker)
+                    return;
+                  if (ep)
+                    stats::get().eppstein_perf(A.size(), ep->m_loops);
+                  else if (m_yen_su)
+                    stats::get().yen_su_perf(A.size(), root.m_pruned);
+                  else if (tree)
+                    stats::get().yen_tree_perf(A.size(), tree->m_saved,
+                                               tree->m_calls);
+                };
+
+  // In each iteration we produce the k-th shortest path.
+  for (int k = 1; !m_K || k <= m_K.value(); ++k)
+    {
+      if (!next())
+        break;
+
+      // This is the k shortest path.
+      const kr_type &r = A.back();
+
+      // The length of the path.
+      COST c = get_path_length(g, r.second);
+
+      // The number of required units at cost c.
+      int units = adaptive_units<COST>::units(ncu, c);
+
+      // This is the selected CU, if the path has the units.
+      if (auto ecu = select_path_cu(g, r.second, cu, units))
+        {
+
+          // The number of costs to store.
+          int costs = A.size() + B.size();
+          // The number of edges to store.
+          int edges = 0;
+
+          for (const auto &p: A)
+            edges += p.second.size();
+
+          for (const auto &p: B)
+            edges += p.second.size();
+
+          // The costs and the edges stored by the Eppstein algorithm.
+          if (ep)
+            {
+              costs += ep->stored_costs();
+              edges += ep->stored_edges();
+            }
+
+          report();
+
+          // We found a solution.
+          return make_tuple(costs, edges, units,
+                            cupath(ecu.value(), r.second));
+        }
+    }
+
+  report();
+
+  // We should never get here, because we call the function only when
+  // we know the solution exists.
+  assert(false);
+  // We put this return instruction here, so that the compile doesn't
+  // complain.
+  return make_tuple(0, 0, 0, cupath(CU(), path()));
+}
+
+tuple<int, int, int, optional<cupath> >
+routing::search_ksp_library(const graph &g, const demand &d,
+                            const CU &cu)
+{
+  vertex src = d.first.first;
+  vertex dst = d.first.second;
+  // The number of contiguous units.
+  int ncu = d.second;
+
+  // The number of edges of the paths examined.
+  int edges = 0;
+
+  // The paths are examined in the order of the Yen algorithm, and so
+  // the result is the same.
+  for (std::size_t k = 0; k < m_kl->count(src, dst); ++k)
+    {
+      path p = m_kl->get(src, dst, k);
+      edges += p.size();
+
+      // The length of the path in the graph.
+      COST c = get_path_length(g, p);
+
+      // This is the candidate SU.
+      SU csu = intersection(m_kl->su(src, dst, k), SU{cu});
+      // The number of required units at cost c.
+      int units = adaptive_units<COST>::units(ncu, c);
+      // Cut those CUs that don't have ncu units.
+      csu.remove(units);
+
+      if (!csu.empty())
+        {
+          // This is the selected CU.
+          CU ecu = select_cu(csu, units);
+
+          // The paths are in the library, and so we account only for
+          // the paths examined.
+          return make_tuple(int(k + 1), edges, units,
+                            cupath(ecu, std::move(p)));
+        }
+    }
+
+  return make_tuple(0, edges, 0, optional<cupath>());
+}
+
+routing::st_t
+routing::st_interpret (const string &st)
+{
+  static const map <string, routing::st_t> st_map
+  {{"first", routing::st_t::first},
+   {"fittest", routing::st_t::fittest},
+   {"random", routing::st_t::random}};
+  return interpret ("spectrum selection type", st, st_map);
+}
+
+void
+routing::set_K(optional<unsigned> K)
+{
+  m_K = K;
+}
+
+optional<unsigned>
+routing::get_K()
+{
+  return m_K;
+}
+
+void
+routing::set_c2f(graph &g, optional<int> k)
+{
+  if (k && k.value() > 1)
+    {
+      m_cg = make_unique<coarse_graph>(g, k.value());
+      // The lower bounds of the search.
+      m_dc = make_unique<distance_cache>(g);
+    }
+  else
+    m_cg.reset();
+}
+
+optional<int>
+routing::get_c2f()
+{
+  if (m_cg)
+    return m_cg->k();
+
+  return {};
+}
+
+void
+routing::set_st(st_t st)
+{
+  m_st = st;
+
+  // The engines select the units of the paths they find with the
+  // policy of the type.
+  m_engines.clear();
+  if (st != st_t::none)
+    for (auto rt: {rt_t::dijkstra, rt_t::parallel})
+      m_engines[rt] = make_engine(rt, st);
+}
+
+void
+routing::set_st(const string &st)
+{
+  set_st(st_interpret(st));
+}
+
+routing::st_t
+routing::get_st()
+{
+  return m_st;
+}
+
+default_random_engine &
+routing::rne()
+{
+  return m_rne;
+}
+
+void
+routing::add_another_algorithm(const routing::rt_t rt)
+{
+  m_aras.insert(rt);
+}
+
+void
+routing::set_auto(const graph &g, bool a, unsigned explore, bool log)
+{
+  m_auto = a;
+  m_auto_log = log;
+  m_os = online_selector<rt_t, features>(explore);
+  // The exact algorithms that can be primary.  The brute force is
+  // too slow, and the Yen algorithm can be inexact with K set.
+  m_os.set_candidates({rt_t::dijkstra, rt_t::parallel});
+  m_ag = &g;
+  m_hd.clear();
+}
+
+int
+routing::hop_distance(const graph &g, vertex src, vertex dst)
+{
+  bool cached = m_ag == &g;
+
+  if (cached)
+    if (auto i = m_hd.find(npair(src, dst)); i != m_hd.end())
+      return i->second;
+
+  // The breadth-first search from src.
+  vector<int> hops(num_vertices(g), -1);
+  std::queue<vertex> Q;
+  hops[src] = 0;
+  Q.push(src);
+
+  while(!Q.empty() && hops[dst] < 0)
+    {
+      vertex v = Q.front();
+      Q.pop();
+
+      for(const auto &e: make_iterator_range(out_edges(v, g)))
+        if (vertex t = boost::target(e, g); hops[t] < 0)
+          {
+            hops[t] = hops[v] + 1;
+            Q.push(t);
+          }
+    }
+
+  if (cached)
+    m_hd[npair(src, dst)] = hops[dst];
+
+  return hops[dst];
+}
+
+routing::rt_t
+routing::auto_select(const graph &g, const demand &d)
+{
+  // The utilization is maintained by the edge counters.
+  double utilization = routing::utilization(g);
+
+  int hops = hop_distance(g, d.first.first, d.first.second);
+  m_af = features(std::ilogb(hops), std::ilogb(d.second),
+                  int(10 * utilization));
+
+  auto [rt, explore] = m_os.select(m_af);
+
+  // Log the decision.
+  if (m_auto_log)
+    cerr << "auto " << hops << " " << d.second << " " << utilization
+         << " " << to_string(rt) << (explore ? " explore" : " exploit")
+         << endl;
+
+  return rt;
+}
+
+void
+routing::set_verify(double rate, unsigned threads)
+{
+  if (rate > 0)
+    m_ver = make_unique<verifier>(rate, threads);
+  else
+    m_ver.reset();
+}
+
+verifier *
+routing::get_verifier()
+{
+  return m_ver.get();
+}
+
+void
+routing::set_reservations(graph &g, bool r)
+{
+  if (r)
+    m_rs = make_unique<reservation_store>(g);
+  else
+    m_rs.reset();
+}
+
+reservation_store *
+routing::get_reservations()
+{
+  return m_rs.get();
+}
+
+void
+routing::set_xcheck(unsigned threads)
+{
+  if (threads)
+    m_xpool = make_unique<thread_pool>(threads);
+  else
+    {
+      xcheck_flush();
+      m_xpool.reset();
     }
+}
 
-  // We assume a cost takes a single word, a label takes two words,
-  // and a CU takes two words.
-  return make_tuple(Q.max_costs, 2 * Q.max_edges, 2 * Q.max_units,
-                    result);
+void
+routing::set_parallel_threads(unsigned threads)
+{
+  if (threads > 1)
+    m_ppool = make_unique<thread_pool>(threads);
+  else
+    m_ppool.reset();
 }
 
-tuple<int, int, int, optional<cupath> >
-routing::search_puyenksp(const graph &g, const demand &d, const CU &cu)
+void
+routing::set_bnb(graph &g, bool bnb)
 {
-  vertex src = d.first.first;
-  vertex dst = d.first.second;
-  // The number of contiguous units.
-  int ncu = d.second;
+  m_bnb = bnb;
 
-  assert (src != dst);
+  // The lower bounds of the search.
+  if (bnb)
+    m_dc = make_unique<distance_cache>(g);
+}
 
-  using ew = boost::edge_weight_t;
-  using wt = boost::property_map<graph, ew>::value_type;
-  using kr_type = boost::Result<wt, graph>;
+void
+routing::set_slot_edges(graph &g, bool se)
+{
+  if (se)
+    m_se = make_unique<slot_edges>(g);
+  else
+    m_se.reset();
+}
 
-  // The shortest paths - these we return.
-  std::list<kr_type> A;
-  std::set<kr_type> B;
+void
+routing::set_occupancy(graph &g, bool om)
+{
+  if (om)
+    m_om = make_unique<occupancy_matrix>(g);
+  else
+    m_om.reset();
+}
 
-  // In each iteration we produce the k-th shortest path.
-  for (int k = 1; !m_K || k <= m_K.value(); ++k)
-    {
-      if (!yen_ksp(g, src, dst,
-                   get(boost::edge_weight_t(), g),
-                   get(boost::vertex_index_t(), g), A, B))
-        break;
+void
+routing::set_fragment_cache(graph &g, bool fc)
+{
+  if (fc)
+    m_fc = make_unique<fragment_cache>(g);
+  else
+    m_fc.reset();
+}
 
-      // This is the k shortest path.
-      const kr_type &r = A.back();
+void
+routing::set_counters(const graph &g)
+{
+  m_ec = make_unique<edge_counters>(g);
+}
 
-      // The length of the path.
-      COST c = get_path_length(g, r.second);
+void
+routing::set_versions(graph &g, bool v)
+{
+  if (v)
+    m_ss = make_unique<spectrum_store>(g);
+  else
+    m_ss.reset();
+}
 
-      // This is the path SU.
-      SU psu = find_path_su(g, r.second);
-      // This is the candidate SU.
-      SU csu = intersection(psu, SU{cu});
-      // The number of required units at cost c.
-      int units = adaptive_units<COST>::units(ncu, c);
-      // Cut those CUs that don't have ncu units.
-      csu.remove(units);
+optional<spectrum_store::view>
+routing::pin(const graph &g)
+{
+  if (m_ss && m_ss->is_of(g))
+    return m_ss->pin();
 
-      if (!csu.empty())
-        {
-          // This is the selected CU.
-          CU ecu = select_cu(csu, units);
+  return {};
+}
 
-          // The number of costs to store.
-          int costs = A.size() + B.size();
-          // The number of edges to store.
-          int edges = 0;
+double
+routing::utilization(const graph &g)
+{
+  if (m_ec && m_ec->is_of(g))
+    return m_ec->utilization();
 
-          for (const auto &p: A)
-            edges += p.second.size();
+  if (m_om && m_om->is_of(g))
+    return m_om->utilization();
 
-          for (const auto &p: B)
-            edges += p.second.size();
+  return calculate_utilization(g);
+}
 
-          // We found a solution.
-          return make_tuple(costs, edges, units,
-                            cupath(ecu, r.second));
-        }
-    }
+double
+routing::fragments(const graph &g)
+{
+  if (m_ec && m_ec->is_of(g))
+    return m_ec->fragments();
 
-  // We should never get here, because we call the function only when
-  // we know the solution exists.
-  assert(false);
-  // We put this return instruction here, so that the compile doesn't
-  // complain.
-  return make_tuple(0, 0, 0, cupath(CU(), path()));
+  return calculate_frags(g);
 }
 
-routing::st_t
-routing::st_interpret (const string &st)
+void
+routing::set_ksp_library(graph &g, unsigned threads,
+                         const optional<string> &file)
 {
-  static const map <string, routing::st_t> st_map
-  {{"first", routing::st_t::first},
-   {"fittest", routing::st_t::fittest},
-   {"random", routing::st_t::random}};
-  return interpret ("spectrum selection type", st, st_map);
+  assert(m_K);
+  m_kl = make_unique<ksp_library>(g, m_K.value(), threads, file);
 }
 
 void
-routing::set_K(optional<unsigned> K)
+routing::set_yen_threads(unsigned threads)
 {
-  m_K = K;
+  if (threads > 1)
+    m_ypool = make_unique<thread_pool>(threads);
+  else
+    m_ypool.reset();
 }
 
-optional<unsigned>
-routing::get_K()
+void
+routing::set_yen_tree(bool yt)
 {
-  return m_K;
+  m_yen_tree = yt;
 }
 
 void
-routing::set_st(st_t st)
+routing::set_yen_su(bool ys)
 {
-  m_st = st;
+  m_yen_su = ys;
 }
 
 void
-routing::set_st(const string &st)
+routing::set_eppstein(bool e)
 {
-  m_st = st_interpret(st);
+  m_eppstein = e;
 }
 
-routing::st_t
-routing::get_st()
+void
+routing::xcheck_flush()
 {
-  return m_st;
+  xcheck_collect(true);
 }
 
 void
-routing::add_another_algorithm(const routing::rt_t rt)
+routing::set_memo(bool memo, bool check)
 {
-  m_aras.insert(rt);
+  m_memo = memo;
+  m_memo_check = check;
 }
 
 bool
@@ -732,84 +2043,399 @@ routing::set_up_path(graph &g, const cupath &p)
   boost::property_map<graph, boost::edge_su_t>::type
     sm = get(boost::edge_su_t(), g);
 
+  if (m_rs && m_rs->is_of(g) && !m_rs->reserve(p))
+    return false;
+
+  bool ec = m_ec && m_ec->is_of(g);
+
   for(const auto &e: p.second)
-    sm[e].remove(p.first);
+    {
+      if (ec)
+        m_ec->remove(e);
+      sm[e].remove(p.first);
+      if (ec)
+        m_ec->add(e);
+    }
+
+  if (m_se && m_se->is_of(g))
+    m_se->update(p);
+
+  if (m_om && m_om->is_of(g))
+    m_om->allocate(p);
+
+  if (m_fc && m_fc->is_of(g))
+    m_fc->update(p.second);
+
+  if (m_cg && m_cg->is_of(g))
+    m_cg->update(p.second);
+
+  if (m_ss && m_ss->is_of(g))
+    m_ss->commit(p.second);
 
   return true;
 }
 
 void
-routing::tear_down(graph &g, const cupath &p)
+routing::release_path(graph &g, const cupath &p)
 {
   boost::property_map<graph, boost::edge_su_t>::type
     sm = get(boost::edge_su_t(), g);
 
+  bool ec = m_ec && m_ec->is_of(g);
+
   // Iterate over the edges of the path.
   for(const auto &e: p.second)
-    sm[e].insert(p.first);
+    {
+      if (ec)
+        m_ec->remove(e);
+      sm[e].insert(p.first);
+      if (ec)
+        m_ec->add(e);
+    }
+
+  if (m_se && m_se->is_of(g))
+    m_se->update(p);
+
+  if (m_om && m_om->is_of(g))
+    m_om->release(p);
+
+  if (m_fc && m_fc->is_of(g))
+    m_fc->update(p.second);
+
+  if (m_cg && m_cg->is_of(g))
+    m_cg->update(p.second);
+
+  if (m_ss && m_ss->is_of(g))
+    m_ss->commit(p.second);
+
+  if (m_rs && m_rs->is_of(g))
+    m_rs->release(p);
+
+  // The units were released, and so the blocked demands can be
+  // feasible now.
+  ++m_release_epoch;
 }
 
-CU
-routing::select_cu(const CU &cu, int ncu)
+unsigned long
+routing::release_epoch()
+{
+  return m_release_epoch;
+}
+
+void
+routing::tear_down(graph &g, const cupath &p)
+{
+  release_path(g, p);
+}
+
+bool
+routing::apply(graph &g, const batch &b)
 {
-  // This is the cunits.
-  CU found;
+  boost::property_map<graph, boost::edge_su_t>::type
+    sm = get(boost::edge_su_t(), g);
 
-  // For now we support only the first spectrum selection type.
-  assert(m_st == st_t::first);
+  // The new SUs of the edges of the batch.
+  map<edge, SU> sus;
 
-  switch (m_st)
+  // Validate the operations in the order of the batch.
+  for(const auto &[p, op]: b)
+    for(const auto &e: p.second)
+      {
+        auto i = sus.find(e);
+        if (i == sus.end())
+          i = sus.insert(make_pair(e, sm[e])).first;
+        SU &su = i->second;
+
+        if (op == op_t::allocate)
+          {
+            if (!su.includes(p.first))
+              return false;
+            su.remove(p.first);
+          }
+        else
+          {
+            if (!intersection(su, SU{p.first}).empty())
+              return false;
+            su.insert(p.first);
+          }
+      }
+
+  // Apply the operations to the store in the order of the batch, so
+  // that the units released are freed before the allocations are
+  // reserved, and the batch can allocate the units it releases.  If
+  // another thread reserved the units of an allocation, the
+  // operations applied are undone in the reverse order: the
+  // allocations are released, and the releases reserved again.
+  if (m_rs && m_rs->is_of(g))
     {
-    case st_t::first:
-      found = select_first(cu, ncu);
-      break;
+      for (auto i = b.begin(); i != b.end(); ++i)
+        if (i->second == op_t::release)
+          m_rs->release(i->first);
+        else if (!m_rs->reserve(i->first))
+          {
+            for (auto j = std::make_reverse_iterator(i); j != b.rend();
+                 ++j)
+              if (j->second == op_t::allocate)
+                m_rs->release(j->first);
+              else
+                {
+                  // The units released can't be taken by another
+                  // thread: under the single-writer contract of the
+                  // store, the other threads reserve only the units
+                  // available in the graph, and the graph has them
+                  // taken until the batch is applied.
+                  [[maybe_unused]] bool r = m_rs->reserve(j->first);
+                  assert(("The single writer of the store was broken.",
+                          r));
+                }
 
-    case st_t::fittest:
-      found = select_fittest(cu, ncu);
-      break;
+            return false;
+          }
+    }
 
-    case st_t::random:
-      found = select_random(cu, ncu);
-      break;
+  bool ec = m_ec && m_ec->is_of(g);
 
-    default:
-      assert(false);
+  // The edges changed.
+  path es;
+
+  // Apply the operations.
+  for(auto &[e, su]: sus)
+    {
+      if (ec)
+        m_ec->remove(e);
+      sm[e] = std::move(su);
+      if (ec)
+        m_ec->add(e);
+      es.push_back(e);
+    }
+
+  if (m_fc && m_fc->is_of(g))
+    m_fc->update(es);
+
+  if (m_cg && m_cg->is_of(g))
+    m_cg->update(es);
+
+  // The batch makes a single version.
+  if (m_ss && m_ss->is_of(g))
+    m_ss->commit(es);
+
+  bool released = false;
+
+  for(const auto &[p, op]: b)
+    {
+      if (m_se && m_se->is_of(g))
+        m_se->update(p);
+
+      if (m_om && m_om->is_of(g))
+        {
+          if (op == op_t::allocate)
+            m_om->allocate(p);
+          else
+            m_om->release(p);
+        }
+
+      released |= op == op_t::release;
     }
 
-  // Make sure the CU has exactly ncu units.
-  return CU(found.min(), found.min() + ncu);
+  // The units were released, and so the blocked demands can be
+  // feasible now.
+  if (released)
+    ++m_release_epoch;
+
+  return true;
 }
 
 CU
-routing::select_first(const CU &cu, int ncu)
+routing::select_cu(const CU &cu, int ncu)
 {
-  assert(cu.count () >= ncu);
-  return CU(cu.min(), cu.min() + ncu);
+  // A CU is an SU of a single fragment.
+  return select_cu(SU{cu}, ncu);
 }
 
-CU
-routing::select_fittest(const CU &cu, int ncu)
+// Call f with the selection policy of the given type.  The random
+// selection draws from the engine of the routing.
+template <typename F>
+static auto
+with_select(routing::st_t st, F f)
 {
-  abort();
-  return CU();
+  switch (st)
+    {
+    case routing::st_t::first:
+      {
+        first_fit s;
+        return f(s);
+      }
+
+    case routing::st_t::fittest:
+      {
+        fittest_fit s;
+        return f(s);
+      }
+
+    case routing::st_t::random:
+      {
+        random_fit s(routing::rne());
+        return f(s);
+      }
+
+    default:
+      abort();
+    }
 }
 
 CU
-routing::select_random(const CU &cu, int ncu)
+routing::select_cu(const SU &su, int ncu)
 {
-  abort();
-  return CU();
+  return with_select(m_st, [&](auto &s){return select_cu(su, ncu, s);});
 }
 
+template <typename Select>
 CU
-routing::select_cu(const SU &su, int ncu)
+routing::select_cu(const SU &su, int ncu, Select &select)
 {
-  // For now we support only the first spectrum selection type.
-  assert(m_st == st_t::first);
-
   assert(!su.empty());
-  const CU &cu = *su.begin();
-  return select_first(cu, ncu);
+
+  // The first fragment has the lowest units, so we don't need the
+  // index.
+  if constexpr (is_same_v<Select, first_fit>)
+    return select(*su.begin(), ncu);
+  else
+    {
+      if (xcheck_worker)
+        return first_fit()(*su.begin(), ncu);
+
+      // The fragments of the SU are scanned, since the index would
+      // not be reused.
+      return select(su, ncu);
+    }
+}
+
+optional<CU>
+routing::select_path_cu(const graph &g, const path &p, const CU &cu,
+                        int ncu)
+{
+  return with_select(m_st, [&](auto &s)
+                     {return select_path_cu(g, p, cu, ncu, s);});
+}
+
+template <typename Select>
+optional<CU>
+routing::select_path_cu(const graph &g, const path &p, const CU &cu,
+                        int ncu, Select &select)
+{
+  constexpr bool first = is_same_v<Select, first_fit>;
+
+  bool om = m_om && m_om->is_of(g);
+
+  // The first fit with the occupancy matrix is a single pass over the
+  // rows of the path.
+  if (om && (first || xcheck_worker))
+    return m_om->first_fit(p, cu, ncu);
+
+  // The cached index of the units available along the path within
+  // cu.
+  if constexpr (!first)
+    if (m_fc && m_fc->is_of(g) && !xcheck_worker)
+      {
+        const fragment_index &fi = m_fc->get(p, cu);
+
+        if (!fi.placements(ncu))
+          return {};
+
+        return select(fi, ncu);
+      }
+
+  // The units available along the path within cu.
+  SU psu = om ? m_om->path_su(p, cu) :
+    intersection(find_path_su(g, p), SU{cu});
+  psu.remove(ncu);
+
+  if (psu.empty())
+    return {};
+
+  return select_cu(psu, ncu, select);
+}
+
+template <typename Select>
+void
+routing::select_units(const graph &g, const CU &cu, int ncu, cupath &p,
+                      Select &select)
+{
+  if (is_same_v<Select, first_fit> || xcheck_worker)
+    // First-fit spectrum allocation policy within the CU of the label.
+    p.first = first_fit()(p.first, ncu);
+  else
+    {
+      // The other policies select from all units available along the
+      // path.
+      auto ecu = select_path_cu(g, p.second, cu, ncu, select);
+      assert(ecu);
+      p.first = ecu.value();
+    }
+}
+
+routing::result
+routing::search_dijkstra(const graph &g, const demand &d, const CU &cu)
+{
+  return engine(rt_t::dijkstra).search(g, d, cu);
+}
+
+routing::result
+routing::search_parallel(const graph &g, const demand &d, const CU &cu)
+{
+  return engine(rt_t::parallel).search(g, d, cu);
+}
+
+basic_engine &
+routing::engine(rt_t rt)
+{
+  auto i = m_engines.find(rt);
+  // The engines are made when the selection type is set.
+  assert(i != m_engines.end());
+  return *i->second;
+}
+
+// Make the engine with the given search and spectrum selection type.
+template <typename Search>
+static unique_ptr<basic_engine>
+make_engine_st(routing::st_t st, bool memo, optional<unsigned> seed)
+{
+  switch (st)
+    {
+    case routing::st_t::first:
+      return make_unique<routing_engine<Search, first_fit>>(memo);
+
+    case routing::st_t::fittest:
+      return make_unique<routing_engine<Search, fittest_fit>>(memo);
+
+    case routing::st_t::random:
+      {
+        random_fit s = seed ? random_fit(seed.value()) :
+          random_fit(routing::rne());
+        return make_unique<routing_engine<Search, random_fit>>
+          (memo, Search(), s);
+      }
+
+    default:
+      abort();
+    }
+}
+
+unique_ptr<basic_engine>
+routing::make_engine(rt_t rt, st_t st, bool memo, optional<unsigned> seed)
+{
+  switch (rt)
+    {
+    case rt_t::dijkstra:
+      return make_engine_st<generic_search>(st, memo, seed);
+
+    case rt_t::parallel:
+      return make_engine_st<parallel_search>(st, memo, seed);
+
+    default:
+      // The other algorithms are not available as engines.
+      abort();
+    }
 }
 
 string
@@ -824,3 +2450,52 @@ routing::to_string(routing::rt_t rt)
   assert(i != t2s.end());
   return i->second;
 }
+
+// The searches of the engines for the cost and selection models.
+template routing::result
+generic_search::operator()<adaptive_units<COST>, first_fit>
+(const graph &, const demand &, const CU &, first_fit &) const;
+
+template routing::result
+generic_search::operator()<adaptive_units<COST>, fittest_fit>
+(const graph &, const demand &, const CU &, fittest_fit &) const;
+
+template routing::result
+generic_search::operator()<adaptive_units<COST>, random_fit>
+(const graph &, const demand &, const CU &, random_fit &) const;
+
+template routing::result
+generic_search::operator()<fixed_units<COST>, first_fit>
+(const graph &, const demand &, const CU &, first_fit &) const;
+
+template routing::result
+generic_search::operator()<fixed_units<COST>, fittest_fit>
+(const graph &, const demand &, const CU &, fittest_fit &) const;
+
+template routing::result
+generic_search::operator()<fixed_units<COST>, random_fit>
+(const graph &, const demand &, const CU &, random_fit &) const;
+
+template routing::result
+parallel_search::operator()<adaptive_units<COST>, first_fit>
+(const graph &, const demand &, const CU &, first_fit &) const;
+
+template routing::result
+parallel_search::operator()<adaptive_units<COST>, fittest_fit>
+(const graph &, const demand &, const CU &, fittest_fit &) const;
+
+template routing::result
+parallel_search::operator()<adaptive_units<COST>, random_fit>
+(const graph &, const demand &, const CU &, random_fit &) const;
+
+template routing::result
+parallel_search::operator()<fixed_units<COST>, first_fit>
+(const graph &, const demand &, const CU &, first_fit &) const;
+
+template routing::result
+parallel_search::operator()<fixed_units<COST>, fittest_fit>
+(const graph &, const demand &, const CU &, fittest_fit &) const;
+
+template routing::result
+parallel_search::operator()<fixed_units<COST>, random_fit>
+(const graph &, const demand &, const CU &, random_fit &) const;
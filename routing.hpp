@@ -1,9 +1,34 @@
 #ifndef ROUTING_HPP
 #define ROUTING_HPP
 
+#include "blocked_memo.hpp"
+#include "coarse_graph.hpp"
+#include "distance_cache.hpp"
+#include "edge_counters.hpp"
+#include "fragment_index.hpp"
 #include "graph.hpp"
-
+#include "ksp_library.hpp"
+#include "online_selector.hpp"
+#include "occupancy_matrix.hpp"
+#include "reservation_store.hpp"
+#include "slot_edges.hpp"
+#include "spectrum_store.hpp"
+#include "thread_pool.hpp"
+#include "verifier.hpp"
+
+#include <deque>
+#include <future>
+#include <map>
+#include <memory>
 #include <optional>
+#include <random>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+struct basic_engine;
+struct generic_search;
+struct parallel_search;
 
 class routing
 {  
@@ -21,6 +46,14 @@ public:
   // puyenksp - the pretty usual Yen KSP
   enum class rt_t {dijkstra, parallel, brtforce, puyenksp};
 
+  // The operation of a batch on the units of a cupath:
+  // allocate - take the units on the edges of the path
+  // release - put back the units on the edges of the path
+  enum class op_t {allocate, release};
+
+  // The batch of the operations.
+  using batch = std::vector<std::pair<cupath, op_t>>;
+
   // Try to set up the demand, i.e., find the path, and allocate
   // resources.  The result returned is the supath set up.
   static std::optional<cupath>
@@ -42,6 +75,15 @@ public:
   static void
   tear_down(graph &g, const cupath &p);
 
+  // Apply the batch of operations to graph g in the order of the
+  // batch.  Every operation is validated first: the units allocated
+  // have to be available, and the units released have to be taken.
+  // If all operations are valid, all of them are applied, and true is
+  // returned.  Otherwise none of them is applied, and false is
+  // returned.  The SU of an edge is read and written once per batch.
+  static bool
+  apply(graph &g, const batch &b);
+
   // The maximum length of a path.
   static void
   set_ml(std::optional<COST> ml);
@@ -56,6 +98,15 @@ public:
   static std::optional<unsigned>
   get_K();
 
+  // The number of units in a super unit of the coarse-to-fine
+  // search, which maintains the coarse graph and the distance cache
+  // of graph g.  If not set, the search is not used.
+  static void
+  set_c2f(graph &g, std::optional<int> k);
+
+  static std::optional<int>
+  get_c2f();
+
   // Set the spectrum selection type.
   static void
   set_st(const st_t st);
@@ -68,9 +119,175 @@ public:
   static st_t
   get_st();
 
+  // The random number engine of the random spectrum selection.
+  static std::default_random_engine &
+  rne();
+
   // What another routing algorithms to run.
   static void add_another_algorithm(const rt_t rt);
 
+  // Select the routing algorithm per demand online, i.e., use the
+  // auto mode.  The algorithm is selected from the exact algorithms,
+  // and every explore-th selection explores another algorithm.  If
+  // log is true, every selection is logged to the standard error.
+  // The state of the auto mode is of graph g, and it's reset.
+  static void
+  set_auto(const graph &g, bool a, unsigned explore = 20,
+           bool log = false);
+
+  // Use the memo of the blocked demands.  If check is true, every
+  // memo hit is validated by running the search anyway.
+  static void
+  set_memo(bool memo, bool check = false);
+
+  // Check in the background that the generic Dijkstra searches are
+  // optimal.  The given fraction of searches is sampled, and checked
+  // with the given number of threads.  The rate of 0 turns the
+  // checks off.
+  static void
+  set_verify(double rate, unsigned threads = 1);
+
+  // The verifier, or nullptr if the checks are off.
+  static verifier *
+  get_verifier();
+
+  // Maintain the reservation store of the units of the edges of
+  // graph g.  A path is then reserved in the store before it's set up
+  // in the graph, and it's released in the store after it's torn down
+  // in the graph.  The threads of a routing front-end reserve the
+  // paths in the store concurrently, and the set up of a path fails
+  // if its units were reserved by them.
+  static void
+  set_reservations(graph &g, bool r);
+
+  // The reservation store, or nullptr if it's not maintained.
+  static reservation_store *
+  get_reservations();
+
+  // Run the other routing algorithms concurrently with the given
+  // number of threads.  With 0 threads, they run one after another.
+  static void
+  set_xcheck(unsigned threads);
+
+  // Search the candidate slots of the parallel search with the given
+  // number of threads.  With 0 or 1 threads, the slots are searched
+  // one after another.
+  static void
+  set_parallel_threads(unsigned threads);
+
+  // Search the slots of the parallel search by branch and bound,
+  // which maintains the distance cache of graph g.  It takes
+  // precedence over the threads of the parallel search.
+  static void
+  set_bnb(graph &g, bool bnb);
+
+  // Maintain the sets of the edges with the slots of graph g for the
+  // parallel search, instead of testing the SU of every edge visited.
+  static void
+  set_slot_edges(graph &g, bool se);
+
+  // Maintain the occupancy matrix of the units of the edges of graph
+  // g, and use it for the units along the paths.
+  static void
+  set_occupancy(graph &g, bool om);
+
+  // Maintain the cache of the fragment indexes of the paths of graph
+  // g, and use it for the fittest and random spectrum selection.
+  static void
+  set_fragment_cache(graph &g, bool fc);
+
+  // Maintain the counters of the units used and of the fragments of
+  // the edges of graph g.
+  static void
+  set_counters(const graph &g);
+
+  // Maintain the versions of the SUs of the edges of graph g, so
+  // that the concurrent readers can pin a consistent version.
+  static void
+  set_versions(graph &g, bool v);
+
+  // Pin the current version of the SUs of the edges of graph g, if
+  // the versions are maintained.
+  static std::optional<spectrum_store::view>
+  pin(const graph &g);
+
+  // The mean utilization of the edges of graph g.
+  static double
+  utilization(const graph &g);
+
+  // The mean number of fragments of the edges of graph g.
+  static double
+  fragments(const graph &g);
+
+  // Use the library of the m_K shortest paths of graph g in the
+  // puyenksp search.  The library is computed with the given number
+  // of threads, or memory-mapped from the file, if given.  The m_K
+  // has to be set.
+  static void
+  set_ksp_library(graph &g, unsigned threads,
+                  const std::optional<std::string> &file = {});
+
+  // Compute the spur paths of the Yen algorithm of the puyenksp
+  // search with the given number of threads.  With 0 or 1 threads,
+  // they are computed one after another.
+  static void
+  set_yen_threads(unsigned threads);
+
+  // Complete the spur paths of the Yen algorithm of the puyenksp
+  // search with the reverse shortest path tree.  It takes precedence
+  // over the threads of the spur paths.
+  static void
+  set_yen_tree(bool yt);
+
+  // Prune the spur paths of the Yen algorithm of the puyenksp search
+  // with the spectrum of the root paths.  It takes precedence over
+  // the reverse shortest path tree and the threads of the spur paths.
+  static void
+  set_yen_su(bool ys);
+
+  // Use the Eppstein algorithm in place of the Yen algorithm in the
+  // puyenksp search.  It takes precedence over the other options of
+  // the Yen algorithm.
+  static void
+  set_eppstein(bool e);
+
+  // Wait for the other routing algorithms, and compare their
+  // results.
+  static void
+  xcheck_flush();
+
+  // Make an engine with the given routing and spectrum selection
+  // types, and with its own state.  The engine is configured at
+  // compile time, and we return it through its run-time interface.
+  // The random selection of the engine draws from its own random
+  // number engine seeded with the seed, if given, and otherwise from
+  // the engine of the routing.
+  static std::unique_ptr<basic_engine>
+  make_engine(rt_t rt, st_t st, bool memo = false,
+              std::optional<unsigned> seed = {});
+
+  // The result of a search: the numbers of costs, edges, and units
+  // stored, and the path found.
+  using result = std::tuple<int, int, int, std::optional<cupath>>;
+
+  // Set up the given path: take its units on the edges, and update
+  // the mirrors of the edges.  False is returned if its units were
+  // reserved concurrently in the reservation store.
+  static bool
+  set_up_path(graph &g, const cupath &p);
+
+  // Release the given path: put back its units on the edges, update
+  // the mirrors of the edges, and begin the next release epoch.
+  static void
+  release_path(graph &g, const cupath &p);
+
+  // The release epoch, which begins anew whenever units are released
+  // in any graph.  The memos of the blocked demands of the routing and
+  // of the engines are in this epoch, so a release by one of them
+  // invalidates them all.
+  static unsigned long
+  release_epoch();
+
   // Return the string of the routing type.
   static std::string
   to_string(routing::rt_t rt);
@@ -86,16 +303,101 @@ public:
   select_cu(const CU &, int ncu);
 
 protected:
-  // Set up the given path.
-  static bool
-  set_up_path(graph &g, const cupath &p);
+  // The features of a demand for the selection of the algorithm: the
+  // log2 of the number of hops of the shortest path, the log2 of the
+  // ncu, and the network utilization in tenths.
+  using features = std::tuple<int, int, int>;
+
+  // The cross-check of another routing algorithm that runs in a
+  // worker thread.  The algorithm searches the snapshot of the graph
+  // taken before the primary result was set up.
+  struct xcheck
+  {
+    // The demand and the CU searched.
+    demand m_d;
+    CU m_cu;
+    // The result of the primary algorithm.
+    std::optional<cupath> m_dr;
+    // The other algorithm.
+    rt_t m_ara;
+    // The snapshot of the graph.
+    std::shared_ptr<const graph> m_g;
+    // The result of the other algorithm, and the time it took.
+    std::future<std::pair<result, double>> m_f;
+  };
+
+  // Run the search, and return its result and the time it took.
+  static std::pair<result, double>
+  timed_search(const graph &g, const demand &d, const CU &cu, rt_t rt);
+
+  // Report the performance of the algorithm.  The auto mode learns
+  // from the time of the searches of the main thread only, because
+  // the cross-checks compete for the cores.
+  static void
+  report_perf(rt_t rt, const result &r, double dt,
+              const features &af);
 
-  // Try to find a shortest path using the generic Dijkstra algorithm.
+  // Compare the result ar of another algorithm with the result dr of
+  // the primary algorithm.  The mismatch is reported with the
+  // spectrum state of graph g.
+  static void
+  xcheck_compare(const graph &g, const demand &d, const CU &cu,
+                 const std::optional<cupath> &dr,
+                 const std::optional<cupath> &ar, rt_t ara);
+
+  // Compare the results of the finished cross-checks, in the order
+  // submitted.  If wait is true, wait for the cross-checks to finish.
+  static void
+  xcheck_collect(bool wait);
+
+  // Select the algorithm for the demand in the auto mode.
+  static rt_t
+  auto_select(const graph &g, const demand &d);
+
+  // The number of hops of the shortest (in hops) path between src and
+  // dst.  It's cached for the graph of the auto mode, and computed
+  // anew for another graph.
+  static int
+  hop_distance(const graph &g, vertex src, vertex dst);
+
+  // The searches of the engines use the mirrors of the routing.
+  friend struct generic_search;
+  friend struct parallel_search;
+
+  // The engine of the routing type.
+  static basic_engine &
+  engine(rt_t rt);
+
+  // The shortest distances from vertex v of graph g regardless of the
+  // units available.  They are taken from the distance cache of the
+  // graph, or computed anew for another graph, e.g., the snapshot of
+  // a cross-check.  The distances computed anew are valid until the
+  // next call in the thread.
+  static const std::vector<COST> &
+  distances(const graph &g, vertex v);
+
+  // Try to find a shortest path using the generic Dijkstra algorithm
+  // with the engine.
   static std::tuple<int, int, int, std::optional<cupath> >
   search_dijkstra(const graph &, const demand &, const CU &);
 
-  // Try to find a shortest path in multiple graphs.  Each graph the
-  // edges filtered to those only that can support the given demand.
+  // Try to find a shortest path with the coarse-to-fine search.  The
+  // coarse pass searches the coarse graph.  The fine pass searches
+  // the original graph filtered to the edges reached by the coarse
+  // pass for paths no longer than the coarse path, and then the whole
+  // original graph for paths no longer than that.  A pass is skipped
+  // if the path found so far is as short as the lower bound: the
+  // shortest distance, or, if the coarse path is longer, the shortest
+  // distance over the edges that fit the units.  The full pass runs
+  // only if the corridor misses a path that can be shorter, and the
+  // stats report the mean number of passes.
+  template <typename Select>
+  static std::tuple<int, int, int, std::optional<cupath> >
+  search_c2f(const graph &, const demand &, const CU &, Select &);
+
+  // Try to find a shortest path in multiple graphs with the engine.
+  // Each graph the edges filtered to those only that can support the
+  // given demand.
   static std::tuple<int, int, int, std::optional<cupath> >
   search_parallel(const graph &, const demand &, const CU &);
 
@@ -108,22 +410,34 @@ protected:
   static std::tuple<int, int, int, std::optional<cupath> >
   search_puyenksp(const graph &, const demand &, const CU &);
 
-  // Select a CU with the lowest unit numbers from SU.  It returns the
-  // whole CU, i.e. it can have more units than ncu.
-  static CU
-  select_first(const CU &, int ncu);
-
-  // Select the fittest CU, i.e. the smallest CU from SU that fits the
-  // required number of units.  It returns the whole available CU,
-  // i.e. it can have more units than ncu.
-  static CU
-  select_fittest(const CU &, int ncu);
+  // Try to find a shortest path among the paths of the library.
+  static std::tuple<int, int, int, std::optional<cupath> >
+  search_ksp_library(const graph &, const demand &, const CU &);
 
-  // Select the random units, i.e. the random CU from SU that fits the
-  // required number of units.  It returns the whole available CU,
-  // i.e. it can have more units than ncu.
+  // Select the CU of ncu units from the SU with the selection
+  // policy.  The cross-check workers select the first fit.
+  template <typename Select>
   static CU
-  select_random(const CU &, int ncu);
+  select_cu(const SU &, int ncu, Select &select);
+
+  // Select the ncu units available along the path p within cu, if
+  // there are any, with the selection policy of the class.
+  static std::optional<CU>
+  select_path_cu(const graph &g, const path &p, const CU &cu, int ncu);
+
+  // Select the ncu units available along the path p within cu, if
+  // there are any, with the given selection policy.
+  template <typename Select>
+  static std::optional<CU>
+  select_path_cu(const graph &g, const path &p, const CU &cu, int ncu,
+                 Select &select);
+
+  // Select the ncu units for the path p found with the CU of a label,
+  // when the search was given the CU cu, with the selection policy.
+  template <typename Select>
+  static void
+  select_units(const graph &g, const CU &cu, int ncu, cupath &p,
+               Select &select);
 
   // Interpret the string and return the spectrum selection type.
   static st_t
@@ -132,11 +446,101 @@ protected:
   // The spectrum selection type.
   static st_t m_st;
 
+  // The engines of the routing types, made for the spectrum
+  // selection type.
+  static std::map<rt_t, std::unique_ptr<basic_engine>> m_engines;
+
   // What another routing algorithms to use.
   static std::set<rt_t> m_aras;
 
   // The K for the k-shortest paths.
   static std::optional<unsigned> m_K;
+
+  // The coarse graph of the coarse-to-fine search.
+  static std::unique_ptr<coarse_graph> m_cg;
+
+  // The cache of the shortest distances of the graph.
+  static std::unique_ptr<distance_cache> m_dc;
+
+  // Use the auto mode.
+  static bool m_auto;
+
+  // Log the selections of the auto mode.
+  static bool m_auto_log;
+
+  // The online selector of the auto mode.
+  static online_selector<rt_t, features> m_os;
+
+  // The features of the demand being set up in the auto mode.
+  static features m_af;
+
+  // The graph of the auto mode, and the cache of its hop distances.
+  // They are used by the main thread only.
+  static const graph *m_ag;
+  static std::map<npair, int> m_hd;
+
+  // Use the memo of the blocked demands.
+  static bool m_memo;
+
+  // Validate every memo hit.
+  static bool m_memo_check;
+
+  // The memo of the blocked demands.
+  static blocked_memo m_bm;
+
+  // The release epoch.
+  static unsigned long m_release_epoch;
+
+  // The random number engine of the random spectrum selection.
+  static std::default_random_engine m_rne;
+
+  // The verifier of the searches.
+  static std::unique_ptr<verifier> m_ver;
+
+  // The threads of the cross-checks.
+  static std::unique_ptr<thread_pool> m_xpool;
+
+  // The cross-checks submitted, but not compared yet.
+  static std::deque<xcheck> m_xchecks;
+
+  // The threads of the parallel search.
+  static std::unique_ptr<thread_pool> m_ppool;
+
+  // Search the slots of the parallel search by branch and bound.
+  static bool m_bnb;
+
+  // The sets of the edges with the slots.
+  static std::unique_ptr<slot_edges> m_se;
+
+  // The occupancy matrix of the units of the edges.
+  static std::unique_ptr<occupancy_matrix> m_om;
+
+  // The cache of the fragment indexes of the paths.
+  static std::unique_ptr<fragment_cache> m_fc;
+
+  // The counters of the units used and of the fragments of the edges.
+  static std::unique_ptr<edge_counters> m_ec;
+
+  // The versions of the SUs of the edges.
+  static std::unique_ptr<spectrum_store> m_ss;
+
+  // The reservation store of the units of the edges.
+  static std::unique_ptr<reservation_store> m_rs;
+
+  // The library of the K shortest paths.
+  static std::unique_ptr<ksp_library> m_kl;
+
+  // The threads of the spur paths of the Yen algorithm.
+  static std::unique_ptr<thread_pool> m_ypool;
+
+  // Complete the spur paths with the reverse shortest path tree.
+  static bool m_yen_tree;
+
+  // Prune the spur paths with the spectrum of the root paths.
+  static bool m_yen_su;
+
+  // Use the Eppstein algorithm in the puyenksp search.
+  static bool m_eppstein;
 };
 
 #endif /* ROUTING_HPP */
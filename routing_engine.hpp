@@ -0,0 +1,251 @@
+#ifndef ROUTING_ENGINE_HPP
+#define ROUTING_ENGINE_HPP
+
+#include "adaptive_units.hpp"
+#include "blocked_memo.hpp"
+#include "fragment_index.hpp"
+#include "graph.hpp"
+#include "routing.hpp"
+
+#include <cassert>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <random>
+#include <set>
+#include <tuple>
+
+// =====================================================================
+// The routing engine is configured at compile time with the search
+// algorithm, the spectrum selection policy, and the cost model.  The
+// engine has its own policies and memo of the blocked demands, but
+// its searches use the mirrors of the edges kept by the routing,
+// e.g., the slot edges and the coarse graph, and so the engines of a
+// graph share them.  The routing class remains the static facade used
+// by the simulation, and it forwards its searches to the engines made
+// by routing::make_engine.  The engines set up and tear down the paths
+// the same way the routing does, so that the mirrors of the edges
+// kept by the routing follow the changes, and so that a release
+// invalidates the memos of all engines and of the routing.
+// =====================================================================
+
+// ---------------------------------------------------------------------
+// The cost models.  A cost model tells the number of units required
+// for a given distance, the reach of a given number of units, and the
+// numbers of units of all modulations.  The adaptive_units class is
+// the cost model with the adaptive modulation.
+// ---------------------------------------------------------------------
+
+// The cost model with a fixed modulation: a demand requires the same
+// number of units regardless of the distance.
+template <typename Cost>
+struct fixed_units
+{
+  static int
+  units(int ncu, Cost)
+  {
+    return ncu;
+  }
+
+  static Cost
+  reach(int, int)
+  {
+    return std::numeric_limits<Cost>::max();
+  }
+
+  static std::set<int>
+  ncus(int ncu)
+  {
+    return {ncu};
+  }
+};
+
+// ---------------------------------------------------------------------
+// The spectrum selection policies.  The first fit selects from a CU,
+// and the other policies select from an SU, or from the fragment
+// index of an SU, when the index is cached.  A policy selects exactly
+// ncu units.
+// ---------------------------------------------------------------------
+
+// Select the units with the lowest numbers.
+struct first_fit
+{
+  CU
+  operator()(const CU &cu, int ncu) const
+  {
+    assert(int(cu.count()) >= ncu);
+    return CU(cu.min(), cu.min() + ncu);
+  }
+};
+
+// Select the units with the lowest numbers from the smallest fragment
+// that fits.
+struct fittest_fit
+{
+  CU
+  operator()(const fragment_index &fi, int ncu) const
+  {
+    auto f = fi.fittest(ncu);
+    assert(f);
+    return first_fit()(f.value(), ncu);
+  }
+
+  CU
+  operator()(const SU &su, int ncu) const
+  {
+    auto f = fittest(su, ncu);
+    assert(f);
+    return first_fit()(f.value(), ncu);
+  }
+};
+
+// Select the units at random from all the units that fit.  The policy
+// has its own random number engine seeded with the given seed, or it
+// draws from the given engine, e.g., the engine of the routing.
+class random_fit
+{
+  std::shared_ptr<std::default_random_engine> m_rne;
+
+public:
+  explicit random_fit(unsigned seed = 1):
+    m_rne(std::make_shared<std::default_random_engine>(seed))
+  {
+  }
+
+  explicit random_fit(std::default_random_engine &rne):
+    m_rne(std::shared_ptr<void>(), &rne)
+  {
+  }
+
+  CU
+  operator()(const fragment_index &fi, int ncu)
+  {
+    auto r = fi.random(ncu, *m_rne);
+    assert(r);
+    return r.value();
+  }
+
+  CU
+  operator()(const SU &su, int ncu)
+  {
+    auto r = random(su, ncu, *m_rne);
+    assert(r);
+    return r.value();
+  }
+};
+
+// ---------------------------------------------------------------------
+// The search algorithms.  A search returns the result of the routing
+// with the units of the path selected with the policy, and the cost
+// model tells the units required.  The searches are implemented and
+// instantiated for the cost and selection models above in routing.cc,
+// because they use the mirrors of the edges kept by the routing.
+// ---------------------------------------------------------------------
+
+// The search with the generic Dijkstra.
+struct generic_search
+{
+  template <typename Model, typename Select>
+  routing::result
+  operator()(const graph &g, const demand &d, const CU &cu,
+             Select &select) const;
+};
+
+// The search in the graphs filtered to the edges that have the units
+// of a candidate slot.
+struct parallel_search
+{
+  template <typename Model, typename Select>
+  routing::result
+  operator()(const graph &g, const demand &d, const CU &cu,
+             Select &select) const;
+};
+
+// ---------------------------------------------------------------------
+// The engines.
+// ---------------------------------------------------------------------
+
+// The interface of an engine configured at run time.
+struct basic_engine
+{
+  virtual
+  ~basic_engine()
+  {
+  }
+
+  // Search for a path without setting it up.
+  virtual routing::result
+  search(const graph &g, const demand &d, const CU &cu) = 0;
+
+  // Try to set up the demand.  The result returned is the cupath set
+  // up.
+  virtual std::optional<cupath>
+  set_up(graph &g, const demand &d, const CU &cu) = 0;
+
+  // Tear down the path in the graph.
+  virtual void
+  tear_down(graph &g, const cupath &p) = 0;
+};
+
+// The engine configured at compile time.  When called through the
+// engine type, and not the basic_engine, the calls are not virtual,
+// and the policies are inlined.
+template <typename Search, typename Select,
+          typename Model = adaptive_units<COST>>
+class routing_engine final: public basic_engine
+{
+  // The search algorithm.
+  Search m_search;
+
+  // The spectrum selection policy.
+  Select m_select;
+
+  // Use the memo of the blocked demands.
+  bool m_memo;
+
+  // The memo of the blocked demands of this engine, in the release
+  // epochs of the routing.
+  blocked_memo m_bm;
+
+public:
+  routing_engine(bool memo = false, Search search = Search(),
+                 Select select = Select()):
+    m_search(search), m_select(select), m_memo(memo)
+  {
+  }
+
+  routing::result
+  search(const graph &g, const demand &d, const CU &cu) override
+  {
+    assert(d.first.first != d.first.second);
+    return m_search.template operator()<Model>(g, d, cu, m_select);
+  }
+
+  std::optional<cupath>
+  set_up(graph &g, const demand &d, const CU &cu) override
+  {
+    if (m_memo && m_bm.is_blocked(d, cu, routing::release_epoch()))
+      return {};
+
+    auto r = std::get<3>(search(g, d, cu));
+
+    if (r)
+      {
+        // The units could have been reserved concurrently.
+        if (!routing::set_up_path(g, r.value()))
+          r.reset();
+      }
+    else if (m_memo)
+      m_bm.blocked(d, cu, routing::release_epoch());
+
+    return r;
+  }
+
+  void
+  tear_down(graph &g, const cupath &p) override
+  {
+    routing::release_path(g, p);
+  }
+};
+
+#endif // ROUTING_ENGINE_HPP
@@ -0,0 +1,107 @@
+#include "slot_edges.hpp"
+#include "utils.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+using namespace std;
+
+slot_edges::slot_edges(graph &g): m_gp(&g), m_edges(index_edges(g)),
+                                  m_pos(m_edges.size())
+{
+  for(const auto &e: m_edges)
+    m_nou = max(m_nou, boost::get(boost::edge_nou, g, e));
+
+  for(const auto &v: boost::make_iterator_range(vertices(g)))
+    {
+      m_first.push_back(m_out.size());
+
+      for(const auto &e: boost::make_iterator_range(out_edges(v, g)))
+        {
+          auto j = boost::get(boost::edge_index, g, e);
+          // The edge has the first position at its source.
+          if (v == boost::source(m_edges[j], g))
+            m_pos[j].first = m_out.size();
+          else
+            m_pos[j].second = m_out.size();
+          m_out.push_back(e);
+        }
+    }
+
+  m_first.push_back(m_out.size());
+}
+
+bool
+slot_edges::is_of(const graph &g) const
+{
+  return m_gp == &g;
+}
+
+const boost::dynamic_bitset<> &
+slot_edges::get(const CU &slot)
+{
+  assert(slot.max() <= m_nou);
+
+  int w = slot.count();
+  auto i = m_sets.find(w);
+
+  if (i == m_sets.end())
+    {
+      // Build the sets of the slots of width w.
+      vector<boost::dynamic_bitset<>> sets(m_nou - w + 1,
+                                           boost::dynamic_bitset<>
+                                           (m_out.size()));
+
+      for (unsigned j = 0; j < m_edges.size(); ++j)
+        {
+          const SU &su = boost::get(boost::edge_su, *m_gp, m_edges[j]);
+          auto [p1, p2] = m_pos[j];
+
+          for (unsigned s = 0; s < sets.size(); ++s)
+            {
+              bool b = su.includes(CU(s, s + w));
+              sets[s][p1] = b;
+              sets[s][p2] = b;
+            }
+        }
+
+      i = m_sets.insert(make_pair(w, std::move(sets))).first;
+    }
+
+  return i->second[slot.min()];
+}
+
+bool
+slot_edges::has(const CU &slot, const edge &e)
+{
+  auto j = boost::get(boost::edge_index, *m_gp, e);
+  return get(slot).test(m_pos[j].first);
+}
+
+void
+slot_edges::update(const edge &e, const CU &cu)
+{
+  const SU &su = boost::get(boost::edge_su, *m_gp, e);
+  auto [p1, p2] = m_pos[boost::get(boost::edge_index, *m_gp, e)];
+
+  for (auto &[w, sets]: m_sets)
+    {
+      // The first units of the slots that overlap cu.
+      unsigned first = cu.min() < unsigned(w) ? 0 : cu.min() - w + 1;
+      unsigned last = min<unsigned>(cu.max(), sets.size());
+
+      for (unsigned s = first; s < last; ++s)
+        {
+          bool b = su.includes(CU(s, s + w));
+          sets[s][p1] = b;
+          sets[s][p2] = b;
+        }
+    }
+}
+
+void
+slot_edges::update(const cupath &p)
+{
+  for(const auto &e: p.second)
+    update(e, p.first);
+}
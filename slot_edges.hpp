@@ -0,0 +1,108 @@
+#ifndef SLOT_EDGES_HPP
+#define SLOT_EDGES_HPP
+
+#include "graph.hpp"
+
+#include <boost/dynamic_bitset.hpp>
+
+#include <map>
+#include <vector>
+
+// The sets of the edges that have the units of a slot available.  A
+// slot of w units starting at unit i is CU(i, i + w).  The sets of a
+// width are built the first time a slot of that width is asked for,
+// and then they are updated as the units are taken and released, so
+// that a search doesn't test the SU of every edge it visits.
+//
+// A set is indexed with the positions of the out edges of the
+// vertices, where the out edges of a vertex take consecutive
+// positions.  An edge has two positions, one for each of its end
+// vertices.  The out edges of a vertex with a slot are found by
+// scanning the words of the set.
+class slot_edges
+{
+  // The graph.
+  const graph *m_gp;
+
+  // The number of units of the edges.
+  unsigned m_nou = 0;
+
+  // The edges indexed with the edge_index property.
+  std::vector<edge> m_edges;
+
+  // The out edges of vertex v are at positions [m_first[v],
+  // m_first[v + 1]) of m_out.
+  std::vector<std::size_t> m_first;
+  std::vector<edge> m_out;
+
+  // The two positions of the edges indexed with the edge_index
+  // property.
+  std::vector<std::pair<std::size_t, std::size_t>> m_pos;
+
+  // The edge sets of the slots of a width, indexed by the first unit
+  // of the slot.
+  std::map<int, std::vector<boost::dynamic_bitset<>>> m_sets;
+
+  // Update the sets of the slots that overlap cu on edge e.
+  void
+  update(const edge &e, const CU &cu);
+
+public:
+  // The edges of the graph are indexed with the edge_index property.
+  explicit slot_edges(graph &g);
+
+  // True if these are the sets of graph g.
+  bool
+  is_of(const graph &g) const;
+
+  // The set of the edges that have the units of the slot.
+  const boost::dynamic_bitset<> &
+  get(const CU &slot);
+
+  // True if edge e has the units of the slot.
+  bool
+  has(const CU &slot, const edge &e);
+
+  // Call f(e) for the out edges e of vertex v in the set of a slot.
+  template <typename F>
+  void
+  for_each_out_edge(const boost::dynamic_bitset<> &set, vertex v,
+                    F f) const
+  {
+    std::size_t first = m_first[v], last = m_first[v + 1];
+
+    for (auto k = first ? set.find_next(first - 1) : set.find_first();
+         k < last; k = set.find_next(k))
+      f(m_out[k]);
+  }
+
+  // Update the sets after the units of the path were taken or
+  // released.
+  void
+  update(const cupath &p);
+};
+
+// The edge predicate of a filtered graph: true if the edge is in the
+// set indexed with the edge_index property.
+struct edge_in_set
+{
+  const graph *m_gp;
+  const boost::dynamic_bitset<> *m_set;
+
+  edge_in_set(): m_gp(0), m_set(0)
+  {
+  }
+
+  edge_in_set(const graph &g, const boost::dynamic_bitset<> &set):
+    m_gp(&g), m_set(&set)
+  {
+  }
+
+  bool
+  operator () (const edge &e) const
+  {
+    return m_set->test(boost::get(boost::edge_index, *m_gp, e));
+  }
+};
+
+#endif // SLOT_EDGES_HPP
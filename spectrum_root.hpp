@@ -0,0 +1,86 @@
+#ifndef SPECTRUM_ROOT_HPP
+#define SPECTRUM_ROOT_HPP
+
+#include "adaptive_units.hpp"
+#include "graph.hpp"
+
+// The root path of the Yen algorithm with the units available along
+// the root path within the candidate units.  The units are carried
+// along the root path as the edges are pushed back.  The root is
+// viable if the units have a CU with the number of units required at
+// the cost of the root path.  The units of a path can only shrink,
+// and the number of units required can only grow as a path gets
+// longer, and so no path that begins with a root path that is not
+// viable has the units required.
+template <typename Model = adaptive_units<COST>>
+class spectrum_root
+{
+  // The graph.
+  const graph &m_g;
+
+  // The candidate units.
+  const SU m_cu;
+
+  // The number of contiguous units requested.
+  const int m_ncu;
+
+  // The cost of the root path.
+  COST m_cost;
+
+  // The units available along the root path.
+  SU m_su;
+
+  // The number of units required at the cost of the root path.
+  int m_units;
+
+public:
+  // The number of the root paths that were not viable.
+  int m_pruned = 0;
+
+  spectrum_root(const graph &g, const CU &cu, int ncu):
+    m_g(g), m_cu{cu}, m_ncu(ncu)
+  {
+    clear();
+  }
+
+  // Make the root path empty.
+  void
+  clear()
+  {
+    m_cost = 0;
+    m_su = m_cu;
+    m_units = Model::units(m_ncu, m_cost);
+  }
+
+  // Push back the edge to the root path.
+  void
+  push_back(const edge &e)
+  {
+    m_cost += boost::get(boost::edge_weight, m_g, e);
+    m_su = intersection(m_su, boost::get(boost::edge_su, m_g, e));
+    m_units = Model::units(m_ncu, m_cost);
+  }
+
+  // True if the root path has the units required.
+  bool
+  viable()
+  {
+    SU su = m_su;
+    su.remove(m_units);
+    bool result = !su.empty();
+    m_pruned += !result;
+    return result;
+  }
+
+  // True if the edge has the units required together with the root
+  // path.
+  bool
+  operator()(const edge &e) const
+  {
+    SU su = intersection(m_su, boost::get(boost::edge_su, m_g, e));
+    su.remove(m_units);
+    return !su.empty();
+  }
+};
+
+#endif // SPECTRUM_ROOT_HPP
@@ -0,0 +1,172 @@
+#include "spectrum_store.hpp"
+#include "utils.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+using namespace std;
+
+spectrum_store::spectrum_store(graph &g, size_t bs): m_gp(&g), m_bs(bs)
+{
+  assert(bs);
+
+  auto es = index_edges(g);
+
+  // The levels of the tree, so that the root covers all edges.
+  m_spans.push_back(m_bs);
+  while (m_spans.back() < es.size())
+    m_spans.push_back(m_spans.back() * fanout);
+
+  m_versions[m_epoch] = build(es, m_spans.size() - 1, 0);
+}
+
+spectrum_store::version
+spectrum_store::build(const vector<edge> &es, size_t level,
+                      size_t first) const
+{
+  auto n = make_shared<node>();
+
+  if (!level)
+    for (size_t i = first; i < min(first + m_bs, es.size()); ++i)
+      n->m_block.push_back(boost::get(boost::edge_su, *m_gp, es[i]));
+  else
+    for (size_t i = first; i < min(first + m_spans[level], es.size());
+         i += m_spans[level - 1])
+      n->m_children.push_back(build(es, level - 1, i));
+
+  return n;
+}
+
+spectrum_store::version
+spectrum_store::update(const node &n, size_t level, const change *first,
+                       const change *last) const
+{
+  auto c = make_shared<node>(n);
+
+  if (!level)
+    for (; first != last; ++first)
+      c->m_block[first->first % m_bs] = *first->second;
+  else
+    while (first != last)
+      {
+        // The child of the first change, and the changes under it.
+        size_t k = first->first / m_spans[level - 1] % fanout;
+        const change *mid = find_if(first, last, [&](const change &x)
+                                    {
+                                      return x.first / m_spans[level - 1] %
+                                        fanout != k;
+                                    });
+        c->m_children[k] = update(*c->m_children[k], level - 1, first,
+                                  mid);
+        first = mid;
+      }
+
+  return c;
+}
+
+bool
+spectrum_store::is_of(const graph &g) const
+{
+  return m_gp == &g;
+}
+
+spectrum_store::view
+spectrum_store::pin() const
+{
+  lock_guard<mutex> lock(m_mutex);
+  ++m_pins[m_epoch];
+  return view(*this, *m_versions.at(m_epoch), m_epoch);
+}
+
+void
+spectrum_store::unpin(unsigned long epoch) const
+{
+  lock_guard<mutex> lock(m_mutex);
+  auto i = m_pins.find(epoch);
+  assert(i != m_pins.end());
+  if (!--i->second)
+    m_pins.erase(i);
+}
+
+void
+spectrum_store::commit(const path &p)
+{
+  // The changes sorted by the indexes of the edges, without repeats.
+  vector<change> cs;
+  for (const auto &e: p)
+    cs.emplace_back(boost::get(boost::edge_index, *m_gp, e),
+                    &boost::get(boost::edge_su, *m_gp, e));
+  sort(cs.begin(), cs.end());
+  cs.erase(unique(cs.begin(), cs.end()), cs.end());
+
+  // The current version can't be reclaimed while we copy it, because
+  // only we commit.
+  version v = m_versions.at(m_epoch);
+  if (!cs.empty())
+    v = update(*v, m_spans.size() - 1, cs.data(), cs.data() + cs.size());
+
+  lock_guard<mutex> lock(m_mutex);
+  m_versions[++m_epoch] = std::move(v);
+  reclaim();
+}
+
+void
+spectrum_store::reclaim()
+{
+  for (auto i = m_versions.begin(); i != m_versions.end();)
+    if (i->first != m_epoch && !m_pins.count(i->first))
+      i = m_versions.erase(i);
+    else
+      ++i;
+}
+
+unsigned long
+spectrum_store::epoch() const
+{
+  lock_guard<mutex> lock(m_mutex);
+  return m_epoch;
+}
+
+size_t
+spectrum_store::versions() const
+{
+  lock_guard<mutex> lock(m_mutex);
+  return m_versions.size();
+}
+
+spectrum_store::view::view(const spectrum_store &ss, const node &root,
+                           unsigned long epoch):
+  m_ssp(&ss), m_root(&root), m_epoch(epoch)
+{
+}
+
+spectrum_store::view::view(view &&v):
+  m_ssp(v.m_ssp), m_root(v.m_root), m_epoch(v.m_epoch)
+{
+  v.m_ssp = nullptr;
+}
+
+spectrum_store::view::~view()
+{
+  if (m_ssp)
+    m_ssp->unpin(m_epoch);
+}
+
+unsigned long
+spectrum_store::view::epoch() const
+{
+  return m_epoch;
+}
+
+const SU &
+spectrum_store::view::operator[](const edge &e) const
+{
+  size_t i = boost::get(boost::edge_index, *m_ssp->m_gp, e);
+  const auto &spans = m_ssp->m_spans;
+
+  const node *n = m_root;
+  for (size_t level = spans.size() - 1; level; --level)
+    n = n->m_children[i / spans[level - 1] % fanout].get();
+
+  return n->m_block[i % m_ssp->m_bs];
+}
@@ -0,0 +1,157 @@
+#ifndef SPECTRUM_STORE_HPP
+#define SPECTRUM_STORE_HPP
+
+#include "graph.hpp"
+
+#include <boost/property_map/property_map.hpp>
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+// The versioned store of the SUs of the edges.  A version is the
+// persistent tree of the blocks of the SUs of the edges indexed with
+// the edge_index property: the leaves are the blocks, and an inner
+// node has the fixed number of children.  The nodes are immutable,
+// and so a new version copies only the blocks of the edges that
+// changed, and the nodes on the way from the root to them, and
+// shares the others with the previous version.
+//
+// A reader pins the current version, and gets the view that doesn't
+// change while the writer commits new versions.  A version that is
+// neither pinned nor current is reclaimed, and so are the blocks that
+// only it used.  The store can be read in many threads, but it should
+// be written in one thread only, the one that changes the graph.
+class spectrum_store
+{
+  // The number of the children of an inner node.
+  static constexpr std::size_t fanout = 16;
+
+  // The node of a version: an inner node has the children, and a
+  // leaf has the block of the SUs of the edges.
+  struct node
+  {
+    std::vector<std::shared_ptr<const node>> m_children;
+    std::vector<SU> m_block;
+  };
+
+  // A version: the root of the tree.
+  using version = std::shared_ptr<const node>;
+
+  // The SU of the edge and its index.
+  using change = std::pair<std::size_t, const SU *>;
+
+  // The graph.
+  const graph *m_gp;
+
+  // The number of edges in a block.
+  std::size_t m_bs;
+
+  // The numbers of the edges under a node by the levels of the tree,
+  // where the leaves are at level 0, and the root at the top.
+  std::vector<std::size_t> m_spans;
+
+  // The mutex of the versions, the epochs and the pins.
+  mutable std::mutex m_mutex;
+
+  // The epoch of the current version.
+  unsigned long m_epoch = 0;
+
+  // The versions by their epochs.
+  std::map<unsigned long, version> m_versions;
+
+  // The number of the readers that pinned a version by its epoch.
+  mutable std::map<unsigned long, unsigned> m_pins;
+
+  // Build the node at the level with the edges from the first.
+  version
+  build(const std::vector<edge> &es, std::size_t level,
+        std::size_t first) const;
+
+  // Copy node n at the level with the changes [first, last), sorted
+  // by the indexes of the edges under the node.
+  version
+  update(const node &n, std::size_t level, const change *first,
+         const change *last) const;
+
+  // Reclaim the versions that are neither pinned nor current.
+  void
+  reclaim();
+
+  // Unpin the version of the epoch.
+  void
+  unpin(unsigned long epoch) const;
+
+public:
+  // The view of a pinned version.  The view is a readable property
+  // map of the SUs of the edges, so that it's read with get(view, e)
+  // in place of get(boost::edge_su, g, e).
+  class view
+  {
+    friend class spectrum_store;
+
+    const spectrum_store *m_ssp;
+    const node *m_root;
+    unsigned long m_epoch;
+
+    view(const spectrum_store &ss, const node &root, unsigned long epoch);
+
+  public:
+    using key_type = edge;
+    using value_type = SU;
+    using reference = const SU &;
+    using category = boost::readable_property_map_tag;
+
+    view(view &&);
+
+    view(const view &) = delete;
+
+    view &
+    operator=(const view &) = delete;
+
+    // Unpins the version.
+    ~view();
+
+    // The epoch of the version.
+    unsigned long
+    epoch() const;
+
+    // The SU of edge e in the version.
+    const SU &
+    operator[](const edge &e) const;
+  };
+
+  // The edges of the graph are indexed with the edge_index property.
+  spectrum_store(graph &g, std::size_t bs = 16);
+
+  // True if this is the store of graph g.
+  bool
+  is_of(const graph &g) const;
+
+  // Pin the current version.
+  view
+  pin() const;
+
+  // Commit the new version with the SUs of the edges of the path
+  // copied from the graph.
+  void
+  commit(const path &p);
+
+  // The epoch of the current version.
+  unsigned long
+  epoch() const;
+
+  // The number of the versions not reclaimed yet.
+  std::size_t
+  versions() const;
+};
+
+inline const SU &
+get(const spectrum_store::view &v, const edge &e)
+{
+  return v[e];
+}
+
+#endif // SPECTRUM_STORE_HPP
@@ -15,7 +15,7 @@ using namespace std;
 stats *stats::singleton;
 
 stats::stats(const cli_args &args, const traffic &tra):
-  m_args(args), m_tra(tra),
+  m_args(args), m_tra(tra), nom(args.nom),
   m_dt((args.sim_time - args.kickoff) / nom)
 {
   assert(!singleton);
@@ -63,12 +63,71 @@ stats::~stats()
       report(prefix + "max_units", ba::max(m_units[rt]));
     }
 
+  // The coarse-to-fine search statistics.
+  if (ba::count(m_c2f_coarse))
+    {
+      report("c2f_mean_coarse_labels", ba::mean(m_c2f_coarse));
+      report("c2f_max_coarse_labels", ba::max(m_c2f_coarse));
+      report("c2f_mean_fine_labels", ba::mean(m_c2f_fine));
+      report("c2f_max_fine_labels", ba::max(m_c2f_fine));
+      report("c2f_mean_passes", ba::mean(m_c2f_passes));
+    }
+
+  // The branch-and-bound statistics of the parallel search.
+  if (ba::count(m_bnb_slots))
+    {
+      report("bnb_mean_slots", ba::mean(m_bnb_slots));
+      report("bnb_mean_pruned", ba::mean(m_bnb_pruned));
+      report("bnb_max_pruned", ba::max(m_bnb_pruned));
+    }
+
+  // The Dijkstra searches saved per path by the reverse shortest path
+  // tree of the puyenksp search.
+  if (ba::count(m_yt_saved))
+    {
+      report("yen_tree_saved_per_k", ba::mean(m_yt_saved));
+      report("yen_tree_calls_per_k", ba::mean(m_yt_calls));
+    }
+
+  // The spur paths pruned per path with the spectrum of the root
+  // paths of the puyenksp search.
+  if (ba::count(m_ys_pruned))
+    report("yen_su_pruned_per_k", ba::mean(m_ys_pruned));
+
+  // The paths with loops skipped per path by the Eppstein algorithm
+  // of the puyenksp search.
+  if (ba::count(m_ep_loops))
+    report("eppstein_loops_per_k", ba::mean(m_ep_loops));
+
   // The number of currently active connections.
   report("conns", ba::mean(m_conns));
   // The capacity served.
   report("capser", ba::mean(m_capser));
   // The mean number of fragments on links.
   report("frags", ba::mean(m_frags));
+
+  // The number of hits of the blocked-demand memo.
+  if (m_args.memo)
+    report("memo_hits", m_memo_hits);
+
+  // The mismatches of the other routing algorithms.
+  if (m_args.parallel || m_args.brtforce || m_args.puyenksp)
+    report("xcheck_mismatches", m_xcheck_mismatches);
+
+  // The contention of the reservation store.
+  if (const reservation_store *rs = routing::get_reservations())
+    {
+      report("reservation_retries", rs->retries());
+      report("reservation_conflicts", rs->conflicts());
+    }
+
+  // The background checks of the searches.
+  if (const verifier *v = routing::get_verifier())
+    {
+      report("verify_runs", v->runs());
+      report("verify_fails", v->fails());
+      report("verify_dropped", v->dropped());
+    }
 }
 
 stats &
@@ -81,13 +140,13 @@ void
 stats::operator()(const double st)
 {
   // The current network utilization.
-  m_utilization(calculate_utilization(m_mdl));
+  m_utilization(routing::utilization(m_mdl));
   // The number of connections served.
   m_conns(m_tra.nr_clients());
   // The capacity served.
   m_capser(m_tra.capacity_served());
   // The number of fragments.
-  m_frags(calculate_frags());
+  m_frags(routing::fragments(m_mdl));
 
   schedule(st);
 }
@@ -123,32 +182,72 @@ stats::established_conn(const connection &conn)
 }
 
 void
-stats::algo_perf(const routing::rt_t rt, const double dt,
-                 const int costs, const int edges, const int units)
+stats::xcheck_mismatch()
+{
+  ++m_xcheck_mismatches;
+}
+
+void
+stats::memo_hit()
+{
+  if (m_args.kickoff <= now())
+    ++m_memo_hits;
+}
+
+void
+stats::c2f_perf(const int coarse, const int fine, const int passes)
 {
   if (m_args.kickoff <= now())
     {
-      cerr << routing::to_string(rt) << " " << dt << endl;
-      m_costs[rt](costs);
-      m_edges[rt](edges);
-      m_units[rt](units);
+      m_c2f_coarse(coarse);
+      m_c2f_fine(fine);
+      m_c2f_passes(passes);
     }
 }
 
-double
-stats::calculate_frags()
+void
+stats::bnb_perf(const int slots, const int pruned)
 {
-  dbl_acc frags;
+  if (m_args.kickoff <= now())
+    {
+      m_bnb_slots(slots);
+      m_bnb_pruned(pruned);
+    }
+}
 
-  // Iterate over all edges.
-  graph::edge_iterator ei, ee;
-  for (tie(ei, ee) = boost::edges(m_mdl); ei != ee; ++ei)
+void
+stats::yen_tree_perf(const int paths, const int saved, const int calls)
+{
+  if (m_args.kickoff <= now() && paths)
     {
-      const edge e = *ei;
-      const SU &su = boost::get(boost::edge_su, m_mdl, e);
-      int f = su.size();
-      frags(f);
+      m_yt_saved(double(saved) / paths);
+      m_yt_calls(double(calls) / paths);
     }
+}
+
+void
+stats::yen_su_perf(const int paths, const int pruned)
+{
+  if (m_args.kickoff <= now() && paths)
+    m_ys_pruned(double(pruned) / paths);
+}
 
-  return ba::mean(frags);
+void
+stats::eppstein_perf(const int paths, const int loops)
+{
+  if (m_args.kickoff <= now() && paths)
+    m_ep_loops(double(loops) / paths);
+}
+
+void
+stats::algo_perf(const routing::rt_t rt, const double dt,
+                 const int costs, const int edges, const int units)
+{
+  if (m_args.kickoff <= now())
+    {
+      cerr << routing::to_string(rt) << " " << dt << endl;
+      m_costs[rt](costs);
+      m_edges[rt](edges);
+      m_units[rt](units);
+    }
 }
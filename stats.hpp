@@ -34,7 +34,7 @@ class stats: public module<sim>
   const cli_args &m_args;
 
   // The number of instantaneous measurements of the network state.
-  const int nom = 100;
+  const int nom;
 
   // The time difference for taking the instantaneous measurements.
   const sim::time_type m_dt;
@@ -70,6 +70,37 @@ class stats: public module<sim>
   // The number of fragments.
   dbl_acc m_frags;
 
+  // The number of hits of the blocked-demand memo.
+  unsigned long m_memo_hits = 0;
+
+  // The number of mismatches of the other routing algorithms.
+  unsigned long m_xcheck_mismatches = 0;
+
+  // The number of labels of the coarse pass.
+  dbl_acc m_c2f_coarse;
+  // The number of labels of the fine pass.
+  dbl_acc m_c2f_fine;
+  // The number of passes: the coarse, the corridor, and the full.
+  dbl_acc m_c2f_passes;
+
+  // The numbers of slots of the branch-and-bound parallel search per
+  // demand, and of the slots pruned.
+  dbl_acc m_bnb_slots;
+  dbl_acc m_bnb_pruned;
+
+  // The numbers of the spur paths completed with the reverse shortest
+  // path tree, and of the Dijkstra searches, per path of a demand.
+  dbl_acc m_yt_saved;
+  dbl_acc m_yt_calls;
+
+  // The number of the spur paths pruned with the spectrum of the root
+  // paths per path of a demand.
+  dbl_acc m_ys_pruned;
+
+  // The number of the paths with loops skipped by the Eppstein
+  // algorithm per path of a demand.
+  dbl_acc m_ep_loops;
+
 public:
   stats(const cli_args &, const traffic &);
 
@@ -92,15 +123,45 @@ public:
   void
   established_conn(const connection &conn);
 
+  // Report the mismatch of another routing algorithm.
+  void
+  xcheck_mismatch();
+
+  // Report the hit of the blocked-demand memo.
+  void
+  memo_hit();
+
+  // Report the number of labels of the coarse and the fine passes of
+  // the coarse-to-fine search, and the number of passes run.
+  void
+  c2f_perf(const int coarse, const int fine, const int passes);
+
+  // Report the numbers of slots, and of the slots pruned, of the
+  // branch-and-bound parallel search of a demand.
+  void
+  bnb_perf(const int slots, const int pruned);
+
+  // Report the numbers of the paths, of the spur paths completed with
+  // the reverse shortest path tree, and of the Dijkstra searches of
+  // the puyenksp search of a demand.
+  void
+  yen_tree_perf(const int paths, const int saved, const int calls);
+
+  // Report the numbers of the paths, and of the spur paths pruned with
+  // the spectrum of the root paths of the puyenksp search of a demand.
+  void
+  yen_su_perf(const int paths, const int pruned);
+
+  // Report the numbers of the paths, and of the paths with loops
+  // skipped by the Eppstein algorithm of the puyenksp search of a
+  // demand.
+  void
+  eppstein_perf(const int paths, const int loops);
+
   // Report the algorithm performance.
   void
   algo_perf(const routing::rt_t rt, const double dt,
             const int costs, const int edges, const int units);
-
-private:
-  // Calculate the average number of fragments on a link.
-  double
-  calculate_frags();
 };
 
 #endif
@@ -0,0 +1,41 @@
+#define BOOST_TEST_MODULE blocked_memo
+
+#include "blocked_memo.hpp"
+#include "graph.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+
+// A blocked demand stays blocked until units are released.
+BOOST_AUTO_TEST_CASE(blocked_memo_test_1)
+{
+  blocked_memo bm;
+  demand d(npair(0, 1), 2);
+  CU cu(0, 10);
+
+  BOOST_CHECK(!bm.is_blocked(d, cu, 0));
+
+  bm.blocked(d, cu, 0);
+  BOOST_CHECK(bm.is_blocked(d, cu, 0));
+
+  // Units were released.
+  BOOST_CHECK(!bm.is_blocked(d, cu, 1));
+
+  // It's blocked again in the new epoch.
+  bm.blocked(d, cu, 1);
+  BOOST_CHECK(bm.is_blocked(d, cu, 1));
+}
+
+// The memo tells apart the end nodes, the ncu, and the CU.
+BOOST_AUTO_TEST_CASE(blocked_memo_test_2)
+{
+  blocked_memo bm;
+  demand d(npair(0, 1), 2);
+  CU cu(0, 10);
+
+  bm.blocked(d, cu, 0);
+  BOOST_CHECK(!bm.is_blocked(demand(npair(1, 0), 2), cu, 0));
+  BOOST_CHECK(!bm.is_blocked(demand(npair(0, 1), 3), cu, 0));
+  BOOST_CHECK(!bm.is_blocked(d, CU(0, 20), 0));
+}
@@ -0,0 +1,126 @@
+#define BOOST_TEST_MODULE calendar_queue
+
+#include "calendar_queue.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <queue>
+#include <random>
+#include <utility>
+#include <vector>
+
+// The event: the time and the number of the event.
+using event = std::pair<double, int>;
+
+struct time_of
+{
+  double
+  operator()(const event &e) const
+  {
+    return e.first;
+  }
+};
+
+using cq_type = calendar_queue<event, time_of>;
+
+// The events of the same time are dequeued in the order they were
+// enqueued.
+BOOST_AUTO_TEST_CASE(calendar_queue_test_1)
+{
+  cq_type q;
+  BOOST_CHECK(q.empty());
+
+  q.push({2, 0});
+  q.push({1, 1});
+  q.push({2, 2});
+  q.push({1, 3});
+  q.push({0.5, 4});
+  BOOST_CHECK(q.size() == 5);
+
+  std::vector<int> order;
+  while(!q.empty())
+    {
+      order.push_back(q.top().second);
+      q.pop();
+    }
+
+  BOOST_CHECK((order == std::vector<int>{4, 1, 3, 0, 2}));
+}
+
+// The hold model: the queue gives the same events as the priority
+// queue ordered by time and the number of the event.
+BOOST_AUTO_TEST_CASE(calendar_queue_test_2)
+{
+  std::default_random_engine rne;
+  std::exponential_distribution<> ed(1);
+  std::uniform_int_distribution<> kd(0, 3);
+
+  cq_type q;
+  std::priority_queue<event, std::vector<event>,
+                      std::greater<event>> pq;
+
+  int n = 0;
+  double now = 0;
+
+  for (int i = 0; i < 100000; ++i)
+    {
+      // Enqueue up to three events, some of them at the current time,
+      // and then dequeue one, so that the queue grows and shrinks.
+      int k = i < 50000 ? kd(rne) : kd(rne) % 2;
+      for (int j = 0; j < k; ++j)
+        {
+          event e(j ? now + ed(rne) : now, n++);
+          q.push(e);
+          pq.push(e);
+        }
+
+      BOOST_REQUIRE(q.size() == pq.size());
+
+      if (!pq.empty())
+        {
+          BOOST_REQUIRE(q.top() == pq.top());
+          now = q.top().first;
+          q.pop();
+          pq.pop();
+        }
+    }
+
+  while(!pq.empty())
+    {
+      BOOST_REQUIRE(q.top() == pq.top());
+      q.pop();
+      pq.pop();
+    }
+
+  BOOST_CHECK(q.empty());
+}
+
+// The hold model with a constant number of events runs for many
+// days, and the end of the current day must not drift from the
+// boundaries of the days.
+BOOST_AUTO_TEST_CASE(calendar_queue_test_3)
+{
+  std::default_random_engine rne;
+  std::uniform_real_distribution<> ud(0, 1);
+
+  cq_type q(0.1);
+  std::priority_queue<event, std::vector<event>,
+                      std::greater<event>> pq;
+
+  for (int n = 0; n < 10; ++n)
+    {
+      event e(ud(rne), n);
+      q.push(e);
+      pq.push(e);
+    }
+
+  for (int n = 10; n < 1000000; ++n)
+    {
+      BOOST_REQUIRE(q.top() == pq.top());
+      event e(pq.top().first + ud(rne), n);
+      q.pop();
+      pq.pop();
+      q.push(e);
+      pq.push(e);
+    }
+}
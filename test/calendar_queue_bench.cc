@@ -0,0 +1,74 @@
+// The throughput of the hold model of the calendar queue and of the
+// binary heap of std::priority_queue.  In the hold model, the queue
+// holds n events, and a hold dequeues the earliest event, and
+// enqueues an event later by the exponentially distributed time, as
+// the client dequeues its event of the arrival, and enqueues its
+// event of the teardown.
+
+#include "calendar_queue.hpp"
+
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <queue>
+#include <random>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+// The event: the time and the number of the event.
+using event = pair<double, int>;
+
+struct time_of
+{
+  double
+  operator()(const event &e) const
+  {
+    return e.first;
+  }
+};
+
+// The number of holds per second of queue q with n events.
+template <typename Q>
+double
+hold(Q &q, int n, int holds)
+{
+  default_random_engine rne;
+  exponential_distribution<> ed(1);
+
+  for (int i = 0; i < n; ++i)
+    q.push(event(ed(rne), i));
+
+  auto t0 = chrono::steady_clock::now();
+
+  for (int i = 0; i < holds; ++i)
+    {
+      double now = q.top().first;
+      q.pop();
+      q.push(event(now + ed(rne), n + i));
+    }
+
+  chrono::duration<double> dt = chrono::steady_clock::now() - t0;
+
+  return holds / dt.count();
+}
+
+int
+main()
+{
+  const int holds = 1000000;
+
+  cout << "events binary_heap calendar_queue" << endl;
+
+  for (int n: {1000, 10000, 100000, 1000000})
+    {
+      priority_queue<event, vector<event>, greater<event>> pq;
+      calendar_queue<event, time_of> cq;
+
+      double bh = hold(pq, n, holds);
+      double cl = hold(cq, n, holds);
+
+      cout << n << " " << bh << " " << cl << endl;
+    }
+}
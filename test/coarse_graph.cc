@@ -0,0 +1,58 @@
+#define BOOST_TEST_MODULE coarse_graph
+
+#include "coarse_graph.hpp"
+#include "graph.hpp"
+#include "utils.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+// A super unit is available only if all its units are.
+BOOST_AUTO_TEST_CASE(coarsen_test_1)
+{
+  BOOST_CHECK(coarsen(CU(0, 8), 4) == CU(0, 2));
+  BOOST_CHECK(coarsen(CU(1, 8), 4) == CU(1, 2));
+  BOOST_CHECK(coarsen(CU(1, 7), 4) == CU());
+  BOOST_CHECK(coarsen(SU{CU(0, 3), CU(4, 12)}, 4) == SU{CU(1, 3)});
+}
+
+// The coarse graph follows the units taken and released.
+BOOST_AUTO_TEST_CASE(coarse_graph_test_1)
+{
+  graph g(3);
+  edge e1 = boost::add_edge(0, 1, g).first;
+  edge e2 = boost::add_edge(1, 2, g).first;
+  set_units(g, 8);
+
+  coarse_graph cg(g, 4);
+  BOOST_CHECK(cg.is_of(g));
+  BOOST_CHECK(cg.k() == 4);
+
+  // The edges of the coarse graph map to the original edges.
+  for (auto ei = edges(cg.get()).first; ei != edges(cg.get()).second;
+       ++ei)
+    {
+      BOOST_CHECK(boost::get(boost::edge_su, cg.get(), *ei) ==
+                  SU{CU(0, 2)});
+      const edge &e = cg.fine(*ei);
+      BOOST_CHECK(e == e1 || e == e2);
+    }
+
+  // Take unit 5 on e1.
+  cupath p(CU(5, 6), path{e1});
+  boost::get(boost::edge_su, g, e1).remove(p.first);
+  cg.update(p.second);
+
+  for (auto ei = edges(cg.get()).first; ei != edges(cg.get()).second;
+       ++ei)
+    BOOST_CHECK(boost::get(boost::edge_su, cg.get(), *ei) ==
+                (cg.fine(*ei) == e1 ? SU{CU(0, 1)} : SU{CU(0, 2)}));
+
+  // Release it.
+  boost::get(boost::edge_su, g, e1).insert(p.first);
+  cg.update(p.second);
+
+  for (auto ei = edges(cg.get()).first; ei != edges(cg.get()).second;
+       ++ei)
+    BOOST_CHECK(boost::get(boost::edge_su, cg.get(), *ei) ==
+                SU{CU(0, 2)});
+}
@@ -0,0 +1,66 @@
+#define BOOST_TEST_MODULE edge_counters
+
+#include "edge_counters.hpp"
+#include "graph.hpp"
+#include "utils.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+// The counters follow the SUs of the edges as they change.
+BOOST_AUTO_TEST_CASE(edge_counters_test_1)
+{
+  graph g(3);
+  edge e1 = boost::add_edge(0, 1, g).first;
+  edge e2 = boost::add_edge(1, 2, g).first;
+  set_units(g, 100);
+
+  edge_counters ec(g);
+  BOOST_CHECK(ec.is_of(g));
+  BOOST_CHECK(ec.utilization() == 0);
+  BOOST_CHECK(ec.fragments() == 1);
+
+  // Take the units in the middle of e1, and at the end of e2.
+  auto take = [&](const edge &e, const CU &cu)
+              {
+                ec.remove(e);
+                boost::get(boost::edge_su, g, e).remove(cu);
+                ec.add(e);
+              };
+
+  take(e1, CU(40, 60));
+  take(e2, CU(80, 100));
+  BOOST_CHECK_CLOSE(ec.utilization(), calculate_utilization(g), 1e-9);
+  BOOST_CHECK_CLOSE(ec.utilization(), 0.2, 1e-9);
+  BOOST_CHECK_CLOSE(ec.fragments(), calculate_frags(g), 1e-9);
+  BOOST_CHECK_CLOSE(ec.fragments(), 1.5, 1e-9);
+
+  // Give the units back.
+  ec.remove(e1);
+  boost::get(boost::edge_su, g, e1).insert(CU(40, 60));
+  ec.add(e1);
+  BOOST_CHECK_CLOSE(ec.utilization(), 0.1, 1e-9);
+  BOOST_CHECK(ec.fragments() == 1);
+}
+
+// The utilization doesn't drift, since the units are counted.
+BOOST_AUTO_TEST_CASE(edge_counters_test_2)
+{
+  graph g(2);
+  edge e = boost::add_edge(0, 1, g).first;
+  set_units(g, 3);
+
+  edge_counters ec(g);
+
+  for (int i = 0; i < 10000; ++i)
+    for (bool take: {true, false})
+      {
+        ec.remove(e);
+        if (take)
+          boost::get(boost::edge_su, g, e).remove(CU(1, 2));
+        else
+          boost::get(boost::edge_su, g, e).insert(CU(1, 2));
+        ec.add(e);
+      }
+
+  BOOST_CHECK(ec.utilization() == 0);
+}
@@ -0,0 +1,97 @@
+#define BOOST_TEST_MODULE eppstein_ksp
+
+#include "eppstein_ksp.hpp"
+#include "graph.hpp"
+#include "utils.hpp"
+#include "yen_ksp.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <list>
+#include <set>
+
+using namespace std;
+
+// The grid graph of n x n vertexes with many paths of equal cost.
+void
+grid_graph(graph &g, int n)
+{
+  g = graph(n * n);
+
+  for (int r = 0; r < n; ++r)
+    for (int c = 0; c < n; ++c)
+      {
+        vertex v = r * n + c;
+        if (c + 1 < n)
+          boost::get(boost::edge_weight, g,
+                     boost::add_edge(v, v + 1, g).first) = 1 + (r + c) % 3;
+        if (r + 1 < n)
+          boost::get(boost::edge_weight, g,
+                     boost::add_edge(v, v + n, g).first) = 1 + (r * c) % 2;
+      }
+}
+
+// True if the path goes from s to t without loops.
+bool
+is_loopless(const graph &g, vertex s, vertex t, const path &p)
+{
+  set<vertex> vs = {s};
+  vertex v = s;
+
+  for (const auto &e: p)
+    {
+      if (boost::source(e, g) != v)
+        return false;
+      v = boost::target(e, g);
+      if (!vs.insert(v).second)
+        return false;
+    }
+
+  return v == t;
+}
+
+// The Eppstein algorithm finds the loopless paths of the same costs
+// as the Yen algorithm.
+BOOST_AUTO_TEST_CASE(eppstein_ksp_test_1)
+{
+  graph g;
+  grid_graph(g, 4);
+
+  auto wm = get(boost::edge_weight_t(), g);
+  auto im = get(boost::vertex_index_t(), g);
+
+  for (vertex s = 0; s < num_vertices(g); ++s)
+    for (vertex t = 0; t < num_vertices(g); ++t)
+      if (s != t)
+        {
+          auto A1 = boost::yen_ksp(g, s, t, wm, im, 50);
+          auto A2 = boost::eppstein_ksp_paths(g, s, t, wm, im, 50);
+
+          BOOST_CHECK(A1.size() == A2.size());
+
+          set<path> ps;
+          for (auto i1 = A1.begin(), i2 = A2.begin(); i1 != A1.end() &&
+                 i2 != A2.end(); ++i1, ++i2)
+            {
+              BOOST_CHECK(i1->first == i2->first);
+              BOOST_CHECK(get_path_length(g, i2->second) == i2->first);
+              BOOST_CHECK(is_loopless(g, s, t, i2->second));
+              BOOST_CHECK(ps.insert(i2->second).second);
+            }
+        }
+}
+
+// The Eppstein algorithm finds all loopless paths, and nothing more.
+BOOST_AUTO_TEST_CASE(eppstein_ksp_test_2)
+{
+  graph g;
+  grid_graph(g, 3);
+
+  auto wm = get(boost::edge_weight_t(), g);
+  auto im = get(boost::vertex_index_t(), g);
+
+  auto A1 = boost::yen_ksp(g, 0, 4, wm, im, {});
+  auto A2 = boost::eppstein_ksp_paths(g, 0, 4, wm, im, {});
+
+  BOOST_CHECK(A1.size() == A2.size());
+}
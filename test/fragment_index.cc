@@ -0,0 +1,126 @@
+#define BOOST_TEST_MODULE fragment_index
+
+#include "fragment_index.hpp"
+#include "graph.hpp"
+#include "utils.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <map>
+#include <random>
+
+using namespace std;
+
+// Find the fittest fragments.
+BOOST_AUTO_TEST_CASE(fragment_index_fittest)
+{
+  fragment_index fi(SU{{0, 5}, {7, 9}, {10, 13}, {20, 22}});
+
+  BOOST_CHECK(fi.fittest(1).value() == CU(7, 9));
+  BOOST_CHECK(fi.fittest(2).value() == CU(7, 9));
+  BOOST_CHECK(fi.fittest(3).value() == CU(10, 13));
+  BOOST_CHECK(fi.fittest(5).value() == CU(0, 5));
+  BOOST_CHECK(!fi.fittest(6));
+}
+
+// Count the placements.
+BOOST_AUTO_TEST_CASE(fragment_index_placements)
+{
+  fragment_index fi(SU{{0, 5}, {7, 9}, {10, 13}});
+
+  BOOST_CHECK(fi.placements(1) == 10);
+  BOOST_CHECK(fi.placements(2) == 4 + 1 + 2);
+  BOOST_CHECK(fi.placements(3) == 3 + 1);
+  BOOST_CHECK(fi.placements(6) == 0);
+  BOOST_CHECK(fragment_index(SU()).placements(1) == 0);
+}
+
+// Every placement is drawn, and it's always feasible.
+BOOST_AUTO_TEST_CASE(fragment_index_random)
+{
+  SU su{{0, 5}, {7, 9}, {10, 13}};
+  fragment_index fi(su);
+  std::default_random_engine eng;
+
+  map<CU, int> counts;
+  for (int i = 0; i < 7000; ++i)
+    {
+      CU cu = fi.random(2, eng).value();
+      BOOST_CHECK(cu.count() == 2);
+      BOOST_CHECK(su.includes(cu));
+      ++counts[cu];
+    }
+
+  // There are seven placements of two units.
+  BOOST_CHECK(counts.size() == 7);
+  for (const auto &p: counts)
+    BOOST_CHECK(800 < p.second && p.second < 1200);
+
+  BOOST_CHECK(!fi.random(6, eng));
+}
+
+// The cached indexes follow the units taken and released.
+BOOST_AUTO_TEST_CASE(fragment_cache_test_1)
+{
+  graph g(3);
+  edge e1 = boost::add_edge(0, 1, g).first;
+  edge e2 = boost::add_edge(1, 2, g).first;
+  set_units(g, 8);
+
+  fragment_cache fc(g);
+  path p{e1, e2};
+
+  const fragment_index *fi = &fc.get(p, CU(0, 8));
+  BOOST_CHECK(fi->fittest(8).value() == CU(0, 8));
+  BOOST_CHECK(fi->placements(3) == 6);
+
+  // The index is reused, if nothing changed.
+  BOOST_CHECK(&fc.get(p, CU(0, 8)) == fi);
+
+  // The index within another CU.
+  BOOST_CHECK(fc.get(p, CU(2, 5)).fittest(1).value() == CU(2, 5));
+
+  // Take units 2 and 3 on e2.
+  boost::get(boost::edge_su, g, e2).remove(CU(2, 4));
+  fc.update(path{e2});
+
+  fi = &fc.get(p, CU(0, 8));
+  BOOST_CHECK(fi->fittest(2).value() == CU(0, 2));
+  BOOST_CHECK(fi->fittest(3).value() == CU(4, 8));
+  BOOST_CHECK(!fi->fittest(5));
+  BOOST_CHECK(fc.get(path{e1}, CU(0, 8)).fittest(5).value() == CU(0, 8));
+
+  // Release them.
+  boost::get(boost::edge_su, g, e2).insert(CU(2, 4));
+  fc.update(path{e2});
+
+  BOOST_CHECK(fc.get(p, CU(0, 8)).fittest(8).value() == CU(0, 8));
+}
+
+// The selections without the index scan the fragments of the SU.
+BOOST_AUTO_TEST_CASE(fragment_index_su)
+{
+  SU su{{0, 5}, {7, 9}, {10, 13}, {20, 22}};
+  fragment_index fi(su);
+
+  for (int n = 1; n <= 6; ++n)
+    BOOST_CHECK(fittest(su, n) == fi.fittest(n));
+
+  std::default_random_engine eng;
+
+  map<CU, int> counts;
+  for (int i = 0; i < 8000; ++i)
+    {
+      CU cu = random(su, 2, eng).value();
+      BOOST_CHECK(cu.count() == 2);
+      BOOST_CHECK(su.includes(cu));
+      ++counts[cu];
+    }
+
+  // There are eight placements of two units.
+  BOOST_CHECK(counts.size() == fi.placements(2));
+  for (const auto &p: counts)
+    BOOST_CHECK(800 < p.second && p.second < 1200);
+
+  BOOST_CHECK(!random(su, 6, eng));
+}
@@ -0,0 +1,113 @@
+#define BOOST_TEST_MODULE ksp_library
+
+#include "graph.hpp"
+#include "ksp_library.hpp"
+#include "yen_ksp.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <cstdio>
+
+using namespace std;
+
+// The graph of two parallel paths:
+//
+// 0 --- (1) --- 1 --- (1) --- 3
+//  \                         /
+//   ---- (2) --- 2 --- (2) --
+void
+ksp_graph(graph &g)
+{
+  g = graph(4);
+  auto add = [&g](vertex s, vertex t, COST w, CU cu)
+             {
+               edge e = boost::add_edge(s, t, g).first;
+               boost::get(boost::edge_weight, g, e) = w;
+               boost::get(boost::edge_su, g, e).insert(cu);
+             };
+
+  add(0, 1, 1, {0, 2});
+  add(1, 3, 1, {1, 3});
+  add(0, 2, 2, {0, 4});
+  add(2, 3, 2, {0, 4});
+}
+
+// The library has the paths of the Yen algorithm.
+BOOST_AUTO_TEST_CASE(ksp_library_test_1)
+{
+  graph g;
+  ksp_graph(g);
+  ksp_library kl(g, 2, 2);
+
+  for (vertex s = 0; s < 4; ++s)
+    for (vertex t = 0; t < 4; ++t)
+      {
+        auto A = boost::yen_ksp(g, s, t, 2);
+        BOOST_CHECK(kl.count(s, t) == A.size());
+
+        size_t k = 0;
+        for (const auto &[c, p]: A)
+          {
+            BOOST_CHECK(kl.cost(s, t, k) == c);
+            BOOST_CHECK(kl.get(s, t, k) == p);
+            ++k;
+          }
+      }
+
+  // The shorter path has only unit 1, and the longer all four.
+  BOOST_CHECK(kl.su(0, 3, 0) == SU{CU(1, 2)});
+  BOOST_CHECK(kl.su(0, 3, 1) == SU{CU(0, 4)});
+}
+
+// The library saved to a file is the same when loaded.
+BOOST_AUTO_TEST_CASE(ksp_library_test_2)
+{
+  string file = "ksp_library_test.bin";
+  remove(file.c_str());
+
+  graph g;
+  ksp_graph(g);
+  ksp_library kl1(g, 2, 1, file);
+  ksp_library kl2(g, 2, 1, file);
+
+  for (vertex s = 0; s < 4; ++s)
+    for (vertex t = 0; t < 4; ++t)
+      {
+        BOOST_CHECK(kl1.count(s, t) == kl2.count(s, t));
+        for (size_t k = 0; k < kl1.count(s, t); ++k)
+          {
+            BOOST_CHECK(kl1.cost(s, t, k) == kl2.cost(s, t, k));
+            BOOST_CHECK(kl1.get(s, t, k) == kl2.get(s, t, k));
+          }
+      }
+
+  // The library of another K is computed again.
+  ksp_library kl3(g, 1, 1, file);
+  BOOST_CHECK(kl3.count(0, 3) == 1);
+
+  remove(file.c_str());
+}
+
+// The library of the graph with other weights isn't loaded.
+BOOST_AUTO_TEST_CASE(ksp_library_test_3)
+{
+  string file = "ksp_library_test.bin";
+  remove(file.c_str());
+
+  graph g;
+  ksp_graph(g);
+  ksp_library kl1(g, 1, 1, file);
+  BOOST_CHECK(kl1.cost(0, 3, 0) == 2);
+
+  // Make the lower path shorter.
+  for (const auto &e: boost::make_iterator_range(boost::edges(g)))
+    if (boost::get(boost::edge_weight, g, e) == 2)
+      boost::get(boost::edge_weight, g, e) = 0.5;
+
+  ksp_library kl2(g, 1, 1, file);
+  BOOST_CHECK(kl2.cost(0, 3, 0) == 1);
+  BOOST_CHECK(kl2.get(0, 3, 0) == (path{boost::edge(0, 2, g).first,
+                                        boost::edge(2, 3, g).first}));
+
+  remove(file.c_str());
+}
@@ -0,0 +1,63 @@
+#define BOOST_TEST_MODULE object_pool
+
+#include "graph.hpp"
+#include "object_pool.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <list>
+#include <thread>
+
+// The path with the nodes from the pool allocator.
+typedef std::list<edge, pool_allocator<edge>> pool_path;
+
+// The memory of an object deallocated is reused.
+BOOST_AUTO_TEST_CASE(object_pool_test_1)
+{
+  object_pool<std::pair<int, double>> p(2);
+  BOOST_CHECK(p.capacity() == 0);
+
+  auto *a = new (p.allocate()) std::pair<int, double>(1, 2);
+  auto *b = new (p.allocate()) std::pair<int, double>(3, 4);
+  BOOST_CHECK(p.size() == 2);
+  BOOST_CHECK(p.capacity() == 2);
+
+  auto *c = new (p.allocate()) std::pair<int, double>(5, 6);
+  BOOST_CHECK(p.capacity() == 4);
+  BOOST_CHECK(a->first == 1 && b->first == 3 && c->first == 5);
+
+  p.deallocate(b);
+  auto *d = new (p.allocate()) std::pair<int, double>(7, 8);
+  BOOST_CHECK(d == b);
+  BOOST_CHECK(p.capacity() == 4);
+
+  for (auto *x: {a, c, d})
+    p.deallocate(x);
+  BOOST_CHECK(p.size() == 0);
+}
+
+// The pool path is a path, and the threads have their own pools.
+BOOST_AUTO_TEST_CASE(object_pool_test_2)
+{
+  graph g(3);
+  edge e1 = boost::add_edge(0, 1, g).first;
+  edge e2 = boost::add_edge(1, 2, g).first;
+
+  path p{e1, e2};
+  pool_path pp(p.begin(), p.end());
+  BOOST_CHECK(std::equal(p.begin(), p.end(), pp.begin(), pp.end()));
+
+  bool equal = false;
+  std::thread t([&]
+                {
+                  pool_path tp(pp);
+                  equal = tp == pp;
+                });
+  t.join();
+  BOOST_CHECK(equal);
+
+  pp.pop_front();
+  pp.push_back(e1);
+  BOOST_CHECK((pp == pool_path{e2, e1}));
+}
@@ -0,0 +1,62 @@
+#define BOOST_TEST_MODULE occupancy_matrix
+
+#include "graph.hpp"
+#include "occupancy_matrix.hpp"
+#include "utils.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+// The units along the path are the same as of the SUs of the edges,
+// also across the words of the rows.
+BOOST_AUTO_TEST_CASE(occupancy_matrix_test_1)
+{
+  graph g(3);
+  edge e1 = boost::add_edge(0, 1, g).first;
+  edge e2 = boost::add_edge(1, 2, g).first;
+  set_units(g, 200);
+
+  occupancy_matrix om(g);
+  path p{e1, e2};
+  CU all(0, 200);
+
+  BOOST_CHECK(om.utilization() == 0);
+  BOOST_CHECK(om.path_su(p, all).count() == 200);
+  BOOST_CHECK(om.first_fit(p, all, 200) == CU(0, 200));
+
+  // Take the units on e1 and e2, so that the units [60, 130) remain
+  // available along the path.
+  cupath p1(CU(0, 60), path{e1});
+  cupath p2(CU(130, 200), path{e2});
+  for (const auto &cp: {p1, p2})
+    {
+      for(const auto &e: cp.second)
+        boost::get(boost::edge_su, g, e).remove(cp.first);
+      om.allocate(cp);
+    }
+
+  BOOST_CHECK(om.path_su(p, all).count() == 70);
+  BOOST_CHECK(om.path_su(p, all).count() ==
+              intersection(find_path_su(g, p), SU{all}).count());
+  BOOST_CHECK(om.first_fit(p, all, 70) == CU(60, 130));
+  BOOST_CHECK(!om.first_fit(p, all, 71));
+  BOOST_CHECK(om.first_fit(p, CU(100, 140), 20) == CU(100, 120));
+  BOOST_CHECK(!om.first_fit(p, CU(100, 140), 31));
+  BOOST_CHECK(om.available(cupath(CU(64, 128), p)));
+  BOOST_CHECK(!om.available(cupath(CU(59, 61), p)));
+  BOOST_CHECK_CLOSE(om.utilization(), calculate_utilization(g), 1e-9);
+  BOOST_CHECK_CLOSE(om.utilization(), 0.325, 1e-9);
+
+  // The snapshot doesn't follow the matrix.
+  auto s = om.snapshot();
+  om.release(p1);
+  BOOST_CHECK(om.first_fit(p, all, 10) == CU(0, 10));
+
+  // The matrix is restored to the snapshot.
+  om.restore(s);
+  BOOST_CHECK(om.first_fit(p, all, 10) == CU(60, 70));
+  BOOST_CHECK_CLOSE(om.utilization(), 0.325, 1e-9);
+
+  om.release(p1);
+  om.release(p2);
+  BOOST_CHECK(om.utilization() == 0);
+}
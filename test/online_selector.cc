@@ -0,0 +1,50 @@
+#define BOOST_TEST_MODULE online_selector
+
+#include "online_selector.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+
+// Exploit the fastest, and explore every so often.
+BOOST_AUTO_TEST_CASE(online_selector_test_1)
+{
+  online_selector<int, int> os(3, 1);
+  os.set_candidates({1, 2});
+
+  // We don't know enough yet.
+  BOOST_CHECK(os.select(0) == make_pair(1, true));
+  os.record(0, 1, 2);
+  BOOST_CHECK(os.select(0) == make_pair(2, true));
+  os.record(0, 2, 1);
+
+  // The third decision explores.
+  BOOST_CHECK(os.select(0) == make_pair(1, true));
+  BOOST_CHECK(os.select(0) == make_pair(2, false));
+  BOOST_CHECK(os.select(0) == make_pair(2, false));
+  BOOST_CHECK(os.select(0).second);
+
+  // The other features know nothing yet.
+  BOOST_CHECK(os.select(1) == make_pair(1, true));
+
+  // Not a candidate.
+  os.record(0, 3, 0);
+  BOOST_CHECK(!os.is_candidate(3));
+}
+
+// The old samples are forgotten when the conditions change.
+BOOST_AUTO_TEST_CASE(online_selector_test_2)
+{
+  online_selector<int, int> os(0, 1, 4);
+  os.set_candidates({1, 2});
+
+  for (int i = 0; i < 100; ++i)
+    os.record(0, 1, 1);
+  os.record(0, 2, 2);
+  BOOST_CHECK(os.select(0) == make_pair(1, false));
+
+  // The exact mean of algorithm 1 would be still below 2.
+  for (int i = 0; i < 10; ++i)
+    os.record(0, 1, 3);
+  BOOST_CHECK(os.select(0) == make_pair(2, false));
+}
@@ -0,0 +1,150 @@
+#define BOOST_TEST_MODULE process
+
+#include "process.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <queue>
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+
+// The simulation of the test: the events of the same time are
+// processed in the order they were scheduled.
+struct test_sim
+{
+  using time_type = double;
+  using model_type = std::vector<std::string>;
+  using rne_type = std::default_random_engine;
+
+  // The event: the time, the number, and the module.
+  using event = std::tuple<double, int, module<test_sim> *>;
+
+  static inline model_type m_log;
+  static inline rne_type m_rne;
+  static inline double m_now = 0;
+  static inline int m_n = 0;
+  static inline std::priority_queue<event, std::vector<event>,
+                                    std::greater<event>> m_q;
+
+  static model_type &
+  mdl()
+  {
+    return m_log;
+  }
+
+  static rne_type &
+  rne()
+  {
+    return m_rne;
+  }
+
+  static double
+  now()
+  {
+    return m_now;
+  }
+
+  static void
+  schedule(double t, module<test_sim> *m)
+  {
+    m_q.push({t, m_n++, m});
+  }
+
+  static void
+  run()
+  {
+    while(!m_q.empty())
+      {
+        auto [t, n, m] = m_q.top();
+        m_q.pop();
+        m_now = t;
+        (*m)(t);
+      }
+  }
+};
+
+// The client that sets up, holds, and tears down.
+process<test_sim>
+client(std::string name, double ht)
+{
+  test_sim::mdl().push_back(name + " up " +
+                            std::to_string(int(test_sim::now())));
+  co_await sleep_until<test_sim>(test_sim::now() + ht);
+  test_sim::mdl().push_back(name + " down " +
+                            std::to_string(int(test_sim::now())));
+}
+
+// The client with two phases.
+process<test_sim>
+reconfigured(std::string name)
+{
+  co_await sleep_until<test_sim>(2);
+  test_sim::mdl().push_back(name + " reconfigured");
+  co_await sleep_until<test_sim>(4);
+  test_sim::mdl().push_back(name + " done");
+}
+
+BOOST_AUTO_TEST_CASE(process_test_1)
+{
+  process_set<test_sim> ps;
+  ps.start(client("a", 3));
+  ps.start(client("b", 1));
+  ps.start(reconfigured("c"));
+  BOOST_CHECK(ps.size() == 3);
+  test_sim::run();
+
+  std::vector<std::string> log = {"a up 0", "b up 0", "b down 1",
+                                  "c reconfigured", "a down 3",
+                                  "c done"};
+  BOOST_CHECK(test_sim::m_log == log);
+
+  ps.prune();
+  BOOST_CHECK(ps.size() == 0);
+}
+
+// The frames are reused.
+BOOST_AUTO_TEST_CASE(process_test_2)
+{
+  void *p = frame_pool::allocate(100);
+  frame_pool::deallocate(p, 100);
+  BOOST_CHECK(frame_pool::allocate(120) == p);
+  frame_pool::deallocate(p, 120);
+}
+
+// The object that counts its destructions.
+struct counted
+{
+  static inline int m_count = 0;
+
+  ~counted()
+  {
+    ++m_count;
+  }
+};
+
+// The process that sleeps long.
+process<test_sim>
+sleeper()
+{
+  counted c;
+  co_await sleep_until<test_sim>(100);
+}
+
+// The processes still sleeping are destroyed with the set.
+BOOST_AUTO_TEST_CASE(process_test_3)
+{
+  {
+    process_set<test_sim> ps;
+    for (int i = 0; i < 100; ++i)
+      ps.start(sleeper());
+    BOOST_CHECK(ps.size() == 100);
+    BOOST_CHECK(counted::m_count == 0);
+  }
+
+  BOOST_CHECK(counted::m_count == 100);
+
+  // The simulation doesn't run the events of the processes destroyed.
+  test_sim::m_q = {};
+}
@@ -0,0 +1,143 @@
+#define BOOST_TEST_MODULE reservation_store
+
+#include "graph.hpp"
+#include "reservation_store.hpp"
+#include "utils.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <atomic>
+#include <random>
+#include <thread>
+#include <vector>
+
+// A path is reserved on all its edges or on none.
+BOOST_AUTO_TEST_CASE(reservation_store_test_1)
+{
+  graph g(3);
+  edge e1 = boost::add_edge(0, 1, g).first;
+  edge e2 = boost::add_edge(1, 2, g).first;
+  set_units(g, 200);
+
+  reservation_store rs(g);
+  BOOST_CHECK(rs.is_of(g));
+
+  cupath p1(CU(60, 130), path{e2});
+  BOOST_CHECK(rs.reserve(p1));
+  BOOST_CHECK(!rs.available(p1));
+
+  // The units of e1 taken are rolled back.
+  cupath p2(CU(0, 70), path{e1, e2});
+  BOOST_CHECK(!rs.reserve(p2));
+  BOOST_CHECK(rs.conflicts() == 1);
+  BOOST_CHECK(rs.available(cupath(CU(0, 200), path{e1})));
+  BOOST_CHECK(rs.available(cupath(CU(0, 60), path{e1, e2})));
+
+  rs.release(p1);
+  BOOST_CHECK(rs.reserve(p2));
+  rs.release(p2);
+  BOOST_CHECK(rs.available(cupath(CU(0, 200), path{e1, e2})));
+}
+
+// The threads reserve and release the random paths, and no unit is
+// ever reserved twice.
+BOOST_AUTO_TEST_CASE(reservation_store_test_2)
+{
+  graph g;
+  BOOST_REQUIRE(load_graphviz("../nets/n100.dot", g));
+  const int nou = 100;
+  set_units(g, nou);
+
+  reservation_store rs(g);
+
+  // The number of the reservations of the units of the edges.
+  std::vector<std::atomic<int>> owners(num_edges(g) * nou);
+  for (auto &o: owners)
+    o = 0;
+
+  std::atomic<bool> twice(false);
+
+  // Count the reservations of the units of the path.
+  auto own = [&](const cupath &p, int d)
+             {
+               for(const auto &e: p.second)
+                 for (int u = p.first.min(); u < p.first.max(); ++u)
+                   if ((owners[boost::get(boost::edge_index, g, e) * nou +
+                                u] += d) > 1)
+                     twice = true;
+             };
+
+  auto worker = [&](unsigned seed)
+                {
+                  std::default_random_engine rne(seed);
+                  std::uniform_int_distribution<> vd(0, num_vertices(g) - 1);
+                  std::uniform_int_distribution<> hd(1, 5);
+                  std::uniform_int_distribution<> ud(0, nou - 1);
+                  std::uniform_int_distribution<> nd(1, 10);
+
+                  // The paths reserved.
+                  std::vector<cupath> ps;
+
+                  for (int i = 0; i < 20000; ++i)
+                    {
+                      // Release a path half of the time.
+                      if (!ps.empty() && rne() % 2)
+                        {
+                          own(ps.back(), -1);
+                          rs.release(ps.back());
+                          ps.pop_back();
+                          continue;
+                        }
+
+                      // The random walk.
+                      path p;
+                      vertex v = vd(rne);
+                      for (int h = hd(rne); h; --h)
+                        {
+                          auto oes = boost::out_edges(v, g);
+                          auto n = boost::out_degree(v, g);
+                          if (!n)
+                            break;
+                          auto ei = oes.first;
+                          std::advance(ei, rne() % n);
+                          p.push_back(*ei);
+                          v = boost::target(*ei, g);
+                        }
+
+                      int u = ud(rne);
+                      CU cu(u, std::min(nou, u + nd(rne)));
+                      // Don't reserve an edge twice in a path.
+                      bool loop = false;
+                      for (auto i = p.begin(); i != p.end(); ++i)
+                        for (auto j = std::next(i); j != p.end(); ++j)
+                          loop |= *i == *j;
+
+                      cupath cp(cu, p);
+                      if (!loop && rs.reserve(cp))
+                        {
+                          own(cp, 1);
+                          ps.push_back(cp);
+                        }
+                    }
+
+                  for (const auto &cp: ps)
+                    {
+                      own(cp, -1);
+                      rs.release(cp);
+                    }
+                };
+
+  unsigned n = std::max(4u, std::thread::hardware_concurrency());
+  std::vector<std::thread> ts;
+  for (unsigned i = 0; i < n; ++i)
+    ts.emplace_back(worker, i);
+  for (auto &t: ts)
+    t.join();
+
+  BOOST_TEST_MESSAGE("conflicts " << rs.conflicts() << " retries " << rs.retries());
+  BOOST_CHECK(!twice);
+
+  // All units are available again.
+  for (const auto &e: boost::make_iterator_range(edges(g)))
+    BOOST_CHECK(rs.available(cupath(CU(0, nou), path{e})));
+}
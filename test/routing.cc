@@ -0,0 +1,359 @@
+#define BOOST_TEST_MODULE routing
+
+#include "adaptive_units.hpp"
+#include "cli_args.hpp"
+#include "graph.hpp"
+#include "routing.hpp"
+#include "sample_graphs.hpp"
+#include "stats.hpp"
+#include "traffic.hpp"
+#include "utils.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <iostream>
+#include <random>
+#include <sstream>
+
+using namespace std;
+
+// The searches report to the stats.
+struct stats_fixture
+{
+  cli_args m_args = cli_args();
+  traffic m_tra;
+  stats m_stats;
+
+  stats_fixture(): m_tra(1, 1, 1), m_stats(m_args, m_tra)
+  {
+  }
+};
+
+BOOST_GLOBAL_FIXTURE(stats_fixture);
+
+// The batch is applied as a whole, or not at all.
+BOOST_AUTO_TEST_CASE(routing_test_1)
+{
+  graph g(3);
+  edge e1 = boost::add_edge(0, 1, g).first;
+  edge e2 = boost::add_edge(1, 2, g).first;
+  set_units(g, 4);
+
+  cupath p1(CU(0, 2), path{e1, e2});
+  cupath p2(CU(2, 4), path{e2});
+  cupath p3(CU(1, 3), path{e1});
+
+  using op_t = routing::op_t;
+
+  // Allocate p1 and p2.
+  BOOST_CHECK(routing::apply(g, {{p1, op_t::allocate},
+                                 {p2, op_t::allocate}}));
+  BOOST_CHECK(boost::get(boost::edge_su, g, e1) == SU{CU(2, 4)});
+  BOOST_CHECK(boost::get(boost::edge_su, g, e2).empty());
+
+  // The allocation of p3 is invalid, and so the release of p2 is not
+  // applied either.
+  BOOST_CHECK(!routing::apply(g, {{p2, op_t::release},
+                                  {p3, op_t::allocate}}));
+  BOOST_CHECK(boost::get(boost::edge_su, g, e1) == SU{CU(2, 4)});
+  BOOST_CHECK(boost::get(boost::edge_su, g, e2).empty());
+
+  // The release of units not taken is invalid.
+  BOOST_CHECK(!routing::apply(g, {{p1, op_t::release},
+                                  {p1, op_t::release}}));
+  BOOST_CHECK(boost::get(boost::edge_su, g, e2).empty());
+
+  // The units released earlier in the batch can be allocated.
+  BOOST_CHECK(routing::apply(g, {{p1, op_t::release},
+                                 {p3, op_t::allocate}}));
+  BOOST_CHECK(boost::get(boost::edge_su, g, e1) ==
+              (SU{CU(0, 1), CU(3, 4)}));
+  BOOST_CHECK(boost::get(boost::edge_su, g, e2) == SU{CU(0, 2)});
+
+  // Release everything.
+  BOOST_CHECK(routing::apply(g, {{p2, op_t::release},
+                                 {p3, op_t::release}}));
+  BOOST_CHECK(boost::get(boost::edge_su, g, e1) == SU{CU(0, 4)});
+  BOOST_CHECK(boost::get(boost::edge_su, g, e2) == SU{CU(0, 4)});
+}
+
+// With the reservation store, the batch can allocate the units it
+// releases, and the store follows the graph.
+BOOST_AUTO_TEST_CASE(routing_test_2)
+{
+  graph g(3);
+  edge e1 = boost::add_edge(0, 1, g).first;
+  edge e2 = boost::add_edge(1, 2, g).first;
+  set_units(g, 4);
+
+  routing::set_reservations(g, true);
+  reservation_store &rs = *routing::get_reservations();
+
+  cupath p1(CU(0, 2), path{e1, e2});
+  cupath p2(CU(1, 3), path{e1});
+
+  using op_t = routing::op_t;
+
+  BOOST_CHECK(routing::apply(g, {{p1, op_t::allocate}}));
+  BOOST_CHECK(!rs.available(p1));
+
+  // Release p1, and allocate p2 with the units of p1.
+  BOOST_CHECK(routing::apply(g, {{p1, op_t::release},
+                                 {p2, op_t::allocate}}));
+  BOOST_CHECK(!rs.available(p2));
+  BOOST_CHECK(rs.available(cupath(CU(0, 1), path{e1})));
+  BOOST_CHECK(rs.available(cupath(CU(0, 4), path{e2})));
+
+  // Another thread reserved the units, and so the batch fails, and
+  // the units released by it are reserved again.
+  cupath p3(CU(3, 4), path{e1});
+  BOOST_CHECK(rs.reserve(p3));
+  BOOST_CHECK(!routing::apply(g, {{p2, op_t::release},
+                                  {p3, op_t::allocate}}));
+  BOOST_CHECK(!rs.available(p2));
+  BOOST_CHECK(boost::get(boost::edge_su, g, e1) ==
+              (SU{CU(0, 1), CU(3, 4)}));
+  rs.release(p3);
+
+  routing::set_reservations(g, false);
+}
+
+// The brute force finds the paths as short as the generic Dijkstra,
+// and with as many units, in the graphs with cycles.
+BOOST_AUTO_TEST_CASE(routing_test_3)
+{
+  adaptive_units<COST>::set_reach_1(10);
+  routing::set_st(routing::st_t::first);
+
+  default_random_engine rne(1);
+  demand d(npair(0, 1), 2);
+
+  for (int i = 0; i < 50; ++i)
+    {
+      graph g;
+      random_graph(g, 8, 12, 16, rne);
+
+      auto dr = routing::search(g, d, CU(0, 16), routing::rt_t::dijkstra);
+      auto br = routing::search(g, d, CU(0, 16), routing::rt_t::brtforce);
+      BOOST_CHECK(bool(dr) == bool(br));
+
+      if (dr && br)
+        {
+          BOOST_CHECK(get_cost(g, dr.value()) == get_cost(g, br.value()));
+          BOOST_CHECK(dr.value().first.count() ==
+                      br.value().first.count());
+        }
+    }
+}
+
+// The coarse-to-fine search finds paths as short as Dijkstra does.
+BOOST_AUTO_TEST_CASE(routing_test_4)
+{
+  adaptive_units<COST>::set_reach_1(10);
+  routing::set_st(routing::st_t::first);
+
+  default_random_engine rne(2);
+
+  for (int i = 0; i < 50; ++i)
+    {
+      graph g;
+      random_graph(g, 8, 12, 16, rne);
+      demand d(npair(0, 1 + i % 7), 1 + i % 3);
+
+      routing::set_c2f(g, {});
+      auto dr = routing::search(g, d, CU(0, 16), routing::rt_t::dijkstra);
+      routing::set_c2f(g, 2 + 2 * (i % 2));
+      auto cr = routing::search(g, d, CU(0, 16), routing::rt_t::dijkstra);
+      routing::set_c2f(g, {});
+      BOOST_CHECK(bool(dr) == bool(cr));
+
+      if (dr && cr)
+        {
+          BOOST_CHECK(get_cost(g, dr.value()) == get_cost(g, cr.value()));
+          BOOST_CHECK(dr.value().first.count() ==
+                      cr.value().first.count());
+        }
+    }
+}
+
+// The branch-and-bound parallel search finds the paths of the
+// parallel search that searches all slots.
+BOOST_AUTO_TEST_CASE(routing_test_5)
+{
+  adaptive_units<COST>::set_reach_1(10);
+  routing::set_st(routing::st_t::first);
+
+  default_random_engine rne(3);
+
+  for (int i = 0; i < 50; ++i)
+    {
+      graph g;
+      random_graph(g, 8, 12, 16, rne);
+      demand d(npair(0, 1 + i % 7), 1 + i % 3);
+
+      routing::set_bnb(g, false);
+      auto pr = routing::search(g, d, CU(0, 16), routing::rt_t::parallel);
+      routing::set_bnb(g, true);
+      auto br = routing::search(g, d, CU(0, 16), routing::rt_t::parallel);
+      routing::set_bnb(g, false);
+      BOOST_CHECK(pr == br);
+    }
+}
+
+// The auto mode sets up the demands with the shortest paths, since
+// it selects from the exact algorithms only.
+BOOST_AUTO_TEST_CASE(routing_test_6)
+{
+  adaptive_units<COST>::set_reach_1(10);
+  routing::set_st(routing::st_t::first);
+
+  default_random_engine rne(4);
+  // The graph outlives the test, since the counters are of it.
+  static graph g;
+
+  for (int i = 0; i < 5; ++i)
+    {
+      random_graph(g, 8, 12, 16, rne);
+      routing::set_counters(g);
+      routing::set_auto(g, true, 2);
+
+      for (int j = 0; j < 20; ++j)
+        {
+          demand d(npair(j % 8, (j + 1 + j % 3) % 8), 1 + j % 2);
+          auto dr = routing::search(g, d, CU(0, 16),
+                                    routing::rt_t::dijkstra);
+          auto ar = routing::set_up(g, d, CU(0, 16));
+          BOOST_CHECK(bool(dr) == bool(ar));
+
+          if (dr && ar)
+            BOOST_CHECK(get_cost(g, dr.value()) ==
+                        get_cost(g, ar.value()));
+        }
+    }
+
+  routing::set_auto(g, false);
+}
+
+// The parallel search with many threads finds the paths of the
+// parallel search with one thread.
+BOOST_AUTO_TEST_CASE(routing_test_7)
+{
+  adaptive_units<COST>::set_reach_1(10);
+  routing::set_st(routing::st_t::first);
+
+  default_random_engine rne(5);
+
+  for (int i = 0; i < 50; ++i)
+    {
+      graph g;
+      random_graph(g, 8, 12, 16, rne);
+      demand d(npair(0, 1 + i % 7), 1 + i % 3);
+
+      routing::set_parallel_threads(1);
+      auto r1 = routing::search(g, d, CU(0, 16), routing::rt_t::parallel);
+      routing::set_parallel_threads(4);
+      auto r4 = routing::search(g, d, CU(0, 16), routing::rt_t::parallel);
+      BOOST_CHECK(r1 == r4);
+    }
+
+  routing::set_parallel_threads(1);
+}
+
+// A blocked demand is a memo hit until a path is torn down.
+BOOST_AUTO_TEST_CASE(routing_test_8)
+{
+  adaptive_units<COST>::set_reach_1(100);
+  routing::set_st(routing::st_t::first);
+
+  graph g(3);
+  edge e1 = boost::add_edge(0, 1, g).first;
+  edge e2 = boost::add_edge(1, 2, g).first;
+  set_units(g, 4);
+
+  demand d(npair(0, 2), 4);
+  routing::set_memo(true);
+
+  auto p = routing::set_up(g, d, CU(0, 4));
+  BOOST_REQUIRE(p);
+  // The demand is blocked, and it's remembered.
+  BOOST_CHECK(!routing::set_up(g, d, CU(0, 4)));
+
+  // The units put back behind the back of the routing are not seen,
+  // because the search is not run on a memo hit.
+  for (const auto &e: {e1, e2})
+    boost::get(boost::edge_su, g, e).insert(p.value().first);
+  BOOST_CHECK(!routing::set_up(g, d, CU(0, 4)));
+  for (const auto &e: {e1, e2})
+    boost::get(boost::edge_su, g, e).remove(p.value().first);
+
+  // The memo hit is checked with the search, which fails indeed.
+  routing::set_memo(true, true);
+  BOOST_CHECK(!routing::set_up(g, d, CU(0, 4)));
+
+  // The tear down invalidates the memo.
+  routing::tear_down(g, p.value());
+  BOOST_CHECK(routing::set_up(g, d, CU(0, 4)));
+
+  routing::set_memo(false);
+}
+
+// The cross-checks run concurrently, and the mismatches are reported
+// in the order of the demands.  It's the last test, because the other
+// algorithm is not removed.
+BOOST_AUTO_TEST_CASE(routing_test_9)
+{
+  adaptive_units<COST>::set_reach_1(100);
+  routing::set_st(routing::st_t::first);
+
+  graph g(3);
+  edge e1 = boost::add_edge(0, 1, g).first;
+  edge e2 = boost::add_edge(0, 2, g).first;
+  edge e3 = boost::add_edge(2, 1, g).first;
+  set_units(g, 8);
+  for (const auto &e: {e1, e2, e3})
+    boost::get(boost::edge_weight, g, e) = 1;
+  // The direct edge has a single unit.
+  boost::get(boost::edge_su, g, e1) = SU{CU(0, 1)};
+
+  // The Yen search with K = 1 tries the shortest path only, and so it
+  // misses the paths around the direct edge.
+  routing::set_K(1);
+  routing::add_another_algorithm(routing::rt_t::puyenksp);
+  routing::set_xcheck(2);
+
+  ostringstream err;
+  auto buf = cerr.rdbuf(err.rdbuf());
+
+  // The results match.
+  demand dc(npair(0, 2), 1);
+  // The results don't match.
+  demand da(npair(0, 1), 2);
+  demand db(npair(1, 0), 2);
+
+  for (const auto &d: {dc, da, db})
+    BOOST_CHECK(routing::set_up(g, d, CU(0, 8)));
+
+  routing::xcheck_flush();
+  cerr.rdbuf(buf);
+
+  string s = err.str();
+  ostringstream sa, sb, sc;
+  sa << "demand = " << da;
+  sb << "demand = " << db;
+  sc << "demand = " << dc;
+
+  auto ia = s.find(sa.str());
+  auto ib = s.find(sb.str());
+  BOOST_CHECK(ia != string::npos && ib != string::npos && ia < ib);
+  BOOST_CHECK(s.find(sc.str()) == string::npos);
+
+  // There are two mismatches.
+  auto i = s.find("xcheck mismatch:");
+  BOOST_REQUIRE(i != string::npos);
+  i = s.find("xcheck mismatch:", i + 1);
+  BOOST_REQUIRE(i != string::npos);
+  BOOST_CHECK(s.find("xcheck mismatch:", i + 1) == string::npos);
+
+  routing::set_xcheck(0);
+  routing::set_K({});
+}
@@ -0,0 +1,136 @@
+#define BOOST_TEST_MODULE routing_engine
+
+#include "routing_engine.hpp"
+
+#include "adaptive_units.hpp"
+#include "graph.hpp"
+#include "routing.hpp"
+#include "sample_graphs.hpp"
+#include "utils.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+
+using namespace std;
+
+// Set up and tear down a path with the generic search engine.
+BOOST_AUTO_TEST_CASE(routing_engine_test_1)
+{
+  adaptive_units<COST>::set_reach_1(100);
+
+  graph g;
+  vector<vertex> vs;
+  vector<edge> es;
+  sample_graph1(g, vs, es);
+
+  routing_engine<generic_search, first_fit> re;
+  demand d(npair(vs[0], vs[2]), 1);
+
+  auto r = re.set_up(g, d, CU(0, 3));
+  BOOST_CHECK(r);
+  BOOST_CHECK(r.value() == cupath(CU(1, 2), path{es[0], es[1]}));
+
+  // The units are taken now.
+  BOOST_CHECK(!get<3>(re.search(g, d, CU(0, 3))));
+
+  re.tear_down(g, r.value());
+  BOOST_CHECK(get<3>(re.search(g, d, CU(0, 3))));
+}
+
+// The engines have their own memos of the blocked demands, and a
+// release by the routing invalidates them.
+BOOST_AUTO_TEST_CASE(routing_engine_test_2)
+{
+  adaptive_units<COST>::set_reach_1(100);
+
+  graph g1, g2;
+  vector<vertex> vs;
+  vector<edge> es;
+  sample_graph1(g1, vs, es);
+  sample_graph1(g2, vs, es);
+
+  routing_engine<generic_search, first_fit> re1(true);
+  routing_engine<parallel_search, first_fit, fixed_units<COST>> re2(true);
+  demand d(npair(vs[0], vs[2]), 1);
+
+  auto r = re1.set_up(g1, d, CU(0, 3));
+  BOOST_CHECK(r);
+  BOOST_CHECK(!re1.set_up(g1, d, CU(0, 3)));
+
+  // The blocked demand of the first engine is not blocked for the
+  // second engine.
+  BOOST_CHECK(re2.set_up(g2, d, CU(0, 3)));
+
+  // The path torn down by the routing is set up by the engine again.
+  routing::tear_down(g1, r.value());
+  BOOST_CHECK(re1.set_up(g1, d, CU(0, 3)));
+}
+
+// The engine keeps the mirrors of the routing in sync.
+BOOST_AUTO_TEST_CASE(routing_engine_test_3)
+{
+  adaptive_units<COST>::set_reach_1(100);
+
+  graph g(3);
+  edge e1 = boost::add_edge(0, 1, g).first;
+  edge e2 = boost::add_edge(1, 2, g).first;
+  set_units(g, 4);
+  routing::set_occupancy(g, true);
+
+  routing_engine<generic_search, first_fit> re;
+  demand d(npair(0, 2), 1);
+
+  auto r = re.set_up(g, d, CU(0, 4));
+  BOOST_CHECK(r);
+  BOOST_CHECK(r.value() == cupath(CU(0, 1), path{e1, e2}));
+  // The utilization of the occupancy matrix.
+  BOOST_CHECK(routing::utilization(g) == 0.25);
+
+  re.tear_down(g, r.value());
+  BOOST_CHECK(routing::utilization(g) == 0);
+
+  routing::set_occupancy(g, false);
+}
+
+// The random selection with the same seed selects the same units.
+BOOST_AUTO_TEST_CASE(routing_engine_test_4)
+{
+  adaptive_units<COST>::set_reach_1(100);
+
+  graph g(2);
+  boost::add_edge(0, 1, g);
+  set_units(g, 64);
+
+  demand d(npair(0, 1), 1);
+  auto re1 = routing::make_engine(routing::rt_t::dijkstra,
+                                  routing::st_t::random, false, 7);
+  auto re2 = routing::make_engine(routing::rt_t::dijkstra,
+                                  routing::st_t::random, false, 7);
+
+  for (int i = 0; i < 10; ++i)
+    BOOST_CHECK(get<3>(re1->search(g, d, CU(0, 64))) ==
+                get<3>(re2->search(g, d, CU(0, 64))));
+}
+
+// The parallel search selects the units with the policy.
+BOOST_AUTO_TEST_CASE(routing_engine_test_5)
+{
+  adaptive_units<COST>::set_reach_1(100);
+
+  graph g(2);
+  edge e = boost::add_edge(0, 1, g).first;
+  set_units(g, 8);
+  // The fragments of 3 and 2 units.
+  boost::get(boost::edge_su, g, e) = SU{CU(0, 3), CU(5, 7)};
+
+  demand d(npair(0, 1), 2);
+
+  routing_engine<parallel_search, first_fit> re1;
+  auto r1 = get<3>(re1.search(g, d, CU(0, 8)));
+  BOOST_CHECK(r1 && r1.value().first == CU(0, 2));
+
+  routing_engine<parallel_search, fittest_fit> re2;
+  auto r2 = get<3>(re2.search(g, d, CU(0, 8)));
+  BOOST_CHECK(r2 && r2.value().first == CU(5, 7));
+}
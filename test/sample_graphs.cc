@@ -23,3 +23,36 @@ sample_graph1(graph &g, vector<vertex> &vs, vector<edge> &ve)
   vs = vector<vertex>{src, mid, dst};
   ve = vector<edge>{e1, e2};
 }
+
+void
+random_graph(graph &g, int n, int m, unsigned nou,
+             default_random_engine &rne)
+{
+  g = graph(n);
+
+  uniform_int_distribution<int> vd(0, n - 1);
+  uniform_int_distribution<int> wd(1, 5);
+  // The first fragment is in the lower half of the units, and the
+  // second in the upper half.
+  uniform_int_distribution<unsigned> ud(0, nou / 2 - 1);
+
+  auto add = [&](vertex a, vertex b)
+             {
+               edge e = boost::add_edge(a, b, g).first;
+               boost::get(boost::edge_weight, g, e) = wd(rne);
+               boost::get(boost::edge_nou, g, e) = nou;
+               SU &su = boost::get(boost::edge_su, g, e);
+               for (unsigned h: {0u, nou / 2})
+                 {
+                   unsigned f = ud(rne), l = ud(rne);
+                   su.insert(CU(h + min(f, l), h + max(f, l) + 1));
+                 }
+             };
+
+  for (int i = 0; i < n; ++i)
+    add(i, (i + 1) % n);
+
+  for (int i = 0; i < m; ++i)
+    if (vertex a = vd(rne), b = vd(rne); a != b)
+      add(a, b);
+}
@@ -3,6 +3,7 @@
 
 #include "graph.hpp"
 
+#include <random>
 #include <tuple>
 #include <vector>
 
@@ -17,4 +18,13 @@
 void
 sample_graph1(graph &g, std::vector<vertex> &vs, std::vector<edge> &ve);
 
+// Returns the ring of n vertices with m chords between random
+// vertices, and so the graph has cycles.  An edge has a random weight
+// from 1 to 5, nou units, and two random fragments of the units
+// available, one in each half of the units.
+
+void
+random_graph(graph &g, int n, int m, unsigned nou,
+             std::default_random_engine &rne);
+
 #endif /* SAMPLE_GRAPHS */
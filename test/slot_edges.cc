@@ -0,0 +1,87 @@
+#define BOOST_TEST_MODULE slot_edges
+
+#include "graph.hpp"
+#include "slot_edges.hpp"
+#include "utils.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+// The sets follow the units taken and released.
+BOOST_AUTO_TEST_CASE(slot_edges_test_1)
+{
+  graph g(3);
+  edge e1 = boost::add_edge(0, 1, g).first;
+  edge e2 = boost::add_edge(1, 2, g).first;
+  set_units(g, 4);
+
+  slot_edges se(g);
+
+  // All edges have all slots, and an edge has two positions.
+  BOOST_CHECK(se.get(CU(0, 2)).count() == 4);
+  BOOST_CHECK(se.get(CU(2, 4)).count() == 4);
+  BOOST_CHECK(se.get(CU(0, 1)).count() == 4);
+
+  // Take unit 1 on e1.
+  cupath p(CU(1, 2), path{e1});
+  boost::get(boost::edge_su, g, e1).remove(p.first);
+  se.update(p);
+
+  BOOST_CHECK(!se.has(CU(0, 2), e1));
+  BOOST_CHECK(!se.has(CU(1, 3), e1));
+  BOOST_CHECK(se.has(CU(2, 4), e1));
+  BOOST_CHECK(se.has(CU(0, 2), e2));
+  BOOST_CHECK(se.has(CU(0, 1), e1));
+  BOOST_CHECK(!se.has(CU(1, 2), e1));
+  BOOST_CHECK(se.has(CU(3, 4), e1));
+
+  // Release it.
+  boost::get(boost::edge_su, g, e1).insert(p.first);
+  se.update(p);
+
+  BOOST_CHECK(se.has(CU(0, 2), e1));
+  BOOST_CHECK(se.has(CU(1, 3), e1));
+  BOOST_CHECK(se.has(CU(1, 2), e1));
+}
+
+// The out edges of a vertex in the set are the out edges with the
+// slot.
+BOOST_AUTO_TEST_CASE(slot_edges_test_2)
+{
+  graph g(4);
+  edge e1 = boost::add_edge(0, 1, g).first;
+  edge e2 = boost::add_edge(1, 2, g).first;
+  edge e3 = boost::add_edge(1, 3, g).first;
+  set_units(g, 4);
+
+  slot_edges se(g);
+
+  // Take unit 0 on e2.
+  cupath p(CU(0, 1), path{e2});
+  boost::get(boost::edge_su, g, e2).remove(p.first);
+  se.update(p);
+
+  const auto &set = se.get(CU(0, 2));
+
+  std::vector<vertex> ts;
+  se.for_each_out_edge(set, 1, [&g, &ts](const edge &e)
+                       {
+                         BOOST_CHECK(boost::source(e, g) == 1);
+                         ts.push_back(boost::target(e, g));
+                       });
+  BOOST_CHECK(ts == std::vector<vertex>({0, 3}));
+
+  ts.clear();
+  se.for_each_out_edge(set, 2, [&g, &ts](const edge &e)
+                       {
+                         ts.push_back(boost::target(e, g));
+                       });
+  BOOST_CHECK(ts.empty());
+
+  ts.clear();
+  se.for_each_out_edge(set, 3, [&g, &ts](const edge &e)
+                       {
+                         ts.push_back(boost::target(e, g));
+                       });
+  BOOST_CHECK(ts == std::vector<vertex>({1}));
+  BOOST_CHECK(se.has(CU(0, 2), e1) && se.has(CU(0, 2), e3));
+}
@@ -0,0 +1,105 @@
+#define BOOST_TEST_MODULE spectrum_store
+
+#include "graph.hpp"
+#include "spectrum_store.hpp"
+#include "utils.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <random>
+#include <utility>
+#include <vector>
+
+// A pinned view doesn't change while the new versions are committed,
+// and the versions neither pinned nor current are reclaimed.
+BOOST_AUTO_TEST_CASE(spectrum_store_test_1)
+{
+  graph g(3);
+  edge e1 = boost::add_edge(0, 1, g).first;
+  edge e2 = boost::add_edge(1, 2, g).first;
+  set_units(g, 100);
+
+  // One edge in a block, so that e2 isn't copied when e1 changes.
+  spectrum_store ss(g, 1);
+  BOOST_CHECK(ss.is_of(g));
+  BOOST_CHECK(ss.versions() == 1);
+
+  auto v0 = ss.pin();
+  BOOST_CHECK(v0.epoch() == 0);
+  BOOST_CHECK(get(v0, e1).count() == 100);
+
+  boost::get(boost::edge_su, g, e1).remove(CU(0, 10));
+  ss.commit(path{e1});
+  BOOST_CHECK(ss.epoch() == 1);
+  BOOST_CHECK(ss.versions() == 2);
+
+  {
+    auto v1 = ss.pin();
+    BOOST_CHECK(get(v0, e1).count() == 100);
+    BOOST_CHECK(get(v1, e1).count() == 90);
+    BOOST_CHECK(&get(v0, e2) == &get(v1, e2));
+
+    boost::get(boost::edge_su, g, e2).remove(CU(0, 20));
+    ss.commit(path{e2});
+    BOOST_CHECK(get(v1, e2).count() == 100);
+    BOOST_CHECK(ss.versions() == 3);
+  }
+
+  // The version of v1 is reclaimed with the next commit.
+  boost::get(boost::edge_su, g, e2).insert(CU(0, 20));
+  ss.commit(path{e2});
+  BOOST_CHECK(ss.versions() == 2);
+
+  auto v3 = ss.pin();
+  BOOST_CHECK(get(v3, e1).count() == 90);
+  BOOST_CHECK(get(v3, e2).count() == 100);
+  BOOST_CHECK(get(v0, e1).count() == 100);
+}
+
+// The versions of a graph with many edges, whose tree has a few
+// levels, keep the SUs of the edges at their commits.
+BOOST_AUTO_TEST_CASE(spectrum_store_test_2)
+{
+  graph g(301);
+  std::vector<edge> es;
+  for (int i = 0; i < 300; ++i)
+    es.push_back(boost::add_edge(i, i + 1, g).first);
+  set_units(g, 100);
+
+  spectrum_store ss(g, 2);
+
+  // The pinned views, and the SUs of the edges at their commits.
+  std::vector<std::pair<spectrum_store::view, std::vector<SU>>> vs;
+
+  std::default_random_engine rne;
+  std::uniform_int_distribution<> ed(0, es.size() - 1);
+  std::uniform_int_distribution<> ud(0, 99);
+
+  for (int i = 0; i < 50; ++i)
+    {
+      // Change a few edges, some of them twice.
+      path p;
+      for (int j = 0; j < 5; ++j)
+        {
+          edge e = es[ed(rne)];
+          int u = ud(rne);
+          SU &su = boost::get(boost::edge_su, g, e);
+          if (su.includes(CU(u, u + 1)))
+            su.remove(CU(u, u + 1));
+          else
+            su.insert(CU(u, u + 1));
+          p.push_back(e);
+          p.push_back(e);
+        }
+      ss.commit(p);
+
+      std::vector<SU> sus;
+      for (const auto &e: es)
+        sus.push_back(boost::get(boost::edge_su, g, e));
+      vs.emplace_back(ss.pin(), std::move(sus));
+    }
+
+  for (const auto &[v, sus]: vs)
+    for (std::size_t i = 0; i < es.size(); ++i)
+      BOOST_REQUIRE(get(v, es[i]) == sus[i]);
+}
@@ -0,0 +1,67 @@
+#define BOOST_TEST_MODULE verifier
+
+#include "verifier.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <atomic>
+#include <thread>
+
+// All the checks are run when the rate is 1, and the failed ones are
+// counted.
+BOOST_AUTO_TEST_CASE(verifier_test_1)
+{
+  verifier v(1, 2);
+
+  int n = 0;
+  for(int i = 0; i < 10 && v.sample(); ++i, ++n)
+    if (v.try_reserve())
+      v.submit([i]{return i % 3;}, "check " + std::to_string(i));
+
+  v.wait();
+
+  BOOST_CHECK(n == 10);
+  BOOST_CHECK(v.runs() + v.dropped() == 10);
+  BOOST_CHECK(v.fails() <= 4);
+}
+
+// No search is sampled when the rate is 0.
+BOOST_AUTO_TEST_CASE(verifier_test_2)
+{
+  verifier v(0, 1);
+
+  for(int i = 0; i < 100; ++i)
+    BOOST_CHECK(!v.sample());
+
+  v.wait();
+  BOOST_CHECK(v.runs() == 0);
+  BOOST_CHECK(v.fails() == 0);
+}
+
+// The samples are dropped when the checks pile up, and the waiting
+// ends when the checks submitted are finished.
+BOOST_AUTO_TEST_CASE(verifier_test_3)
+{
+  verifier v(1, 1);
+  std::atomic<bool> go(false);
+
+  unsigned long n = 0;
+  while (n < 1000 && v.try_reserve())
+    {
+      v.submit([&go]
+               {
+                 while (!go)
+                   std::this_thread::yield();
+                 return true;
+               }, "check");
+      ++n;
+    }
+
+  BOOST_CHECK(n < 1000);
+  BOOST_CHECK(v.dropped() == 1);
+
+  go = true;
+  v.wait();
+  BOOST_CHECK(v.runs() == n);
+  BOOST_CHECK(v.fails() == 0);
+}
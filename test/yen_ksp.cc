@@ -0,0 +1,328 @@
+#define BOOST_TEST_MODULE yen_ksp
+
+#include "graph.hpp"
+#include "thread_pool.hpp"
+#include "utils.hpp"
+#include "yen_ksp.hpp"
+
+#include <boost/graph/dijkstra_shortest_paths.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <list>
+#include <optional>
+#include <set>
+
+using namespace std;
+
+// The grid graph of n x n vertexes with many paths of equal cost.
+void
+grid_graph(graph &g, int n)
+{
+  g = graph(n * n);
+
+  for (int r = 0; r < n; ++r)
+    for (int c = 0; c < n; ++c)
+      {
+        vertex v = r * n + c;
+        if (c + 1 < n)
+          boost::get(boost::edge_weight, g,
+                     boost::add_edge(v, v + 1, g).first) = 1 + (r + c) % 2;
+        if (r + 1 < n)
+          boost::get(boost::edge_weight, g,
+                     boost::add_edge(v, v + n, g).first) = 1;
+      }
+}
+
+// The parallel variant finds the same paths as the serial one.
+BOOST_AUTO_TEST_CASE(yen_ksp_test_1)
+{
+  using kr_type = boost::Result<COST, graph>;
+
+  graph g;
+  grid_graph(g, 4);
+  thread_pool pool(4);
+
+  auto pf = [&pool](size_t n, const auto &f)
+            {
+              pool.parallel_for(n, f);
+            };
+
+  for (vertex s = 0; s < num_vertices(g); ++s)
+    for (vertex t = 0; t < num_vertices(g); ++t)
+      if (s != t)
+        {
+          list<kr_type> A1, A2;
+          set<kr_type> B1, B2;
+
+          for (int k = 1; k <= 20; ++k)
+            {
+              bool r1 = yen_ksp(g, s, t, get(boost::edge_weight_t(), g),
+                                get(boost::vertex_index_t(), g), A1, B1);
+              bool r2 = yen_ksp(g, s, t, get(boost::edge_weight_t(), g),
+                                get(boost::vertex_index_t(), g), A2, B2,
+                                pf);
+              BOOST_CHECK(r1 == r2);
+              if (!r1)
+                break;
+            }
+
+          BOOST_CHECK(A1 == A2);
+          BOOST_CHECK(B1 == B2);
+        }
+}
+
+// The variant with the workspace finds the paths of the same costs.
+BOOST_AUTO_TEST_CASE(yen_ksp_test_2)
+{
+  using kr_type = boost::Result<COST, graph>;
+
+  graph g;
+  grid_graph(g, 4);
+  boost::dijkstra_workspace<graph, COST> ws;
+
+  for (vertex s = 0; s < num_vertices(g); ++s)
+    for (vertex t = 0; t < num_vertices(g); ++t)
+      if (s != t)
+        {
+          list<kr_type> A1, A2;
+          set<kr_type> B1, B2;
+
+          for (int k = 1; k <= 20; ++k)
+            {
+              bool r1 = yen_ksp(g, s, t, get(boost::edge_weight_t(), g),
+                                get(boost::vertex_index_t(), g), A1, B1);
+              bool r2 = yen_ksp(g, s, t, get(boost::edge_weight_t(), g),
+                                get(boost::vertex_index_t(), g), A2, B2,
+                                ws);
+              BOOST_CHECK(r1 == r2);
+              if (!r1)
+                break;
+            }
+
+          BOOST_CHECK(A1.size() == A2.size());
+          for (auto i1 = A1.begin(), i2 = A2.begin(); i1 != A1.end();
+               ++i1, ++i2)
+            {
+              BOOST_CHECK(i1->first == i2->first);
+              BOOST_CHECK(get_path_length(g, i2->second) == i2->first);
+            }
+        }
+}
+
+// The variant with the reverse shortest path tree finds the paths of
+// the same costs, and completes some spur paths with the tree.
+BOOST_AUTO_TEST_CASE(yen_ksp_test_3)
+{
+  using kr_type = boost::Result<COST, graph>;
+
+  graph g;
+  grid_graph(g, 4);
+
+  auto wm = get(boost::edge_weight_t(), g);
+  auto im = get(boost::vertex_index_t(), g);
+  std::size_t saved = 0, calls = 0;
+
+  for (vertex s = 0; s < num_vertices(g); ++s)
+    for (vertex t = 0; t < num_vertices(g); ++t)
+      if (s != t)
+        {
+          boost::yen_tree<graph, decltype(wm), decltype(im)>
+            tree(g, t, wm, im);
+          list<kr_type> A1, A2;
+          set<kr_type> B1, B2;
+
+          for (int k = 1; k <= 20; ++k)
+            {
+              bool r1 = yen_ksp(g, s, t, wm, im, A1, B1);
+              bool r2 = yen_ksp(g, s, t, wm, im, A2, B2, tree);
+              BOOST_CHECK(r1 == r2);
+              if (!r1)
+                break;
+            }
+
+          BOOST_CHECK(A1.size() == A2.size());
+          for (auto i1 = A1.begin(), i2 = A2.begin(); i1 != A1.end();
+               ++i1, ++i2)
+            {
+              BOOST_CHECK(i1->first == i2->first);
+              BOOST_CHECK(get_path_length(g, i2->second) == i2->first);
+            }
+
+          saved += tree.m_saved;
+          calls += tree.m_calls;
+        }
+
+  BOOST_CHECK(saved);
+}
+
+// The root that allows the paths of at most m_hops edges of weight 1.
+struct hops_root
+{
+  int m_hops;
+  int m_root = 0;
+
+  void
+  clear()
+  {
+    m_root = 0;
+  }
+
+  void
+  push_back(const edge &)
+  {
+    ++m_root;
+  }
+
+  bool
+  viable() const
+  {
+    return m_root < m_hops;
+  }
+
+  bool
+  operator()(const edge &e) const;
+};
+
+graph g5;
+
+bool
+hops_root::operator()(const edge &e) const
+{
+  return boost::get(boost::edge_weight, g5, e) == 1;
+}
+
+// True if the path is allowed by the root of that many hops.
+bool
+is_allowed(const path &p, int hops)
+{
+  return p.size() <= hops &&
+    all_of(p.begin(), p.end(), [](const edge &e)
+           {return boost::get(boost::edge_weight, g5, e) == 1;});
+}
+
+// The variant with the root finds the same shortest allowed path as
+// the plain variant.
+BOOST_AUTO_TEST_CASE(yen_ksp_test_4)
+{
+  using kr_type = boost::Result<COST, graph>;
+
+  grid_graph(g5, 4);
+  boost::dijkstra_workspace<graph, COST> ws;
+
+  auto wm = get(boost::edge_weight_t(), g5);
+  auto im = get(boost::vertex_index_t(), g5);
+
+  for (int hops = 1; hops <= 8; ++hops)
+    for (vertex s = 0; s < num_vertices(g5); ++s)
+      for (vertex t = 0; t < num_vertices(g5); ++t)
+        if (s != t)
+          {
+            // The first allowed path of the plain variant.
+            optional<COST> c1;
+            list<kr_type> A1;
+            set<kr_type> B1;
+            while (!c1 && yen_ksp(g5, s, t, wm, im, A1, B1))
+              if (is_allowed(A1.back().second, hops))
+                c1 = A1.back().first;
+
+            // The first allowed path of the variant with the root.
+            optional<COST> c2;
+            hops_root root{hops};
+            list<kr_type> A2;
+            set<kr_type> B2;
+            while (!c2 && yen_ksp(g5, s, t, wm, im, A2, B2, ws, root))
+              if (is_allowed(A2.back().second, hops))
+                c2 = A2.back().first;
+
+            BOOST_CHECK(c1 == c2);
+            // The variant with the root finds fewer paths.
+            BOOST_CHECK(A2.size() <= A1.size());
+          }
+}
+
+// The workspace finds the same paths as the BGL Dijkstra, which
+// breaks the ties of the costs in the grid of unit weights.
+BOOST_AUTO_TEST_CASE(yen_ksp_test_5)
+{
+  graph g;
+  grid_graph(g, 5);
+  for (const auto &e: boost::make_iterator_range(boost::edges(g)))
+    boost::get(boost::edge_weight, g, e) = 1;
+
+  auto wm = get(boost::edge_weight_t(), g);
+  auto im = get(boost::vertex_index_t(), g);
+  boost::dijkstra_workspace<graph, COST> ws;
+
+  for (vertex s = 0; s < num_vertices(g); ++s)
+    {
+      // The predecessor edges of the BGL Dijkstra that doesn't stop.
+      vector<edge> pred(num_vertices(g));
+      auto rep = boost::record_edge_predecessors
+        (boost::make_iterator_property_map(pred.begin(), im),
+         boost::on_edge_relaxed());
+      boost::dijkstra_shortest_paths
+        (g, s, boost::weight_map(wm).vertex_index_map(im).
+         visitor(boost::make_dijkstra_visitor(rep)));
+
+      for (vertex t = 0; t < num_vertices(g); ++t)
+        if (s != t)
+          {
+            path p;
+            for (vertex c = t; c != s; c = boost::source(pred[c], g))
+              p.push_front(pred[c]);
+
+            auto r1 = ws(g, s, t, wm, im);
+            auto r2 = boost::custom_dijkstra_call(g, s, t, wm, im);
+            BOOST_REQUIRE(r1 && r2);
+            BOOST_CHECK(r1.value().second == p);
+            BOOST_CHECK(r2.value().second == p);
+          }
+    }
+}
+
+// The workspace and the custom Dijkstra call find the paths of the BGL
+// Dijkstra in the sample networks.
+BOOST_AUTO_TEST_CASE(yen_ksp_test_6)
+{
+  for (const string &net: {"n10", "n20", "euro28", "n50", "n100"})
+    {
+      graph g;
+      BOOST_REQUIRE(load_graphviz("../nets/" + net + ".dot", g));
+
+      auto wm = get(boost::edge_weight_t(), g);
+      auto im = get(boost::vertex_index_t(), g);
+      boost::dijkstra_workspace<graph, COST> ws;
+
+      for (vertex s = 0; s < num_vertices(g); ++s)
+        {
+          // The distances and the predecessor edges of the BGL
+          // Dijkstra that doesn't stop.
+          vector<COST> dist(num_vertices(g));
+          vector<edge> pred(num_vertices(g));
+          auto rep = boost::record_edge_predecessors
+            (boost::make_iterator_property_map(pred.begin(), im),
+             boost::on_edge_relaxed());
+          boost::dijkstra_shortest_paths
+            (g, s, boost::weight_map(wm).vertex_index_map(im).
+             distance_map(&dist[0]).
+             visitor(boost::make_dijkstra_visitor(rep)));
+
+          for (vertex t = 0; t < num_vertices(g); ++t)
+            if (s != t)
+              {
+                path p;
+                for (vertex c = t; c != s; c = boost::source(pred[c], g))
+                  p.push_front(pred[c]);
+
+                auto r1 = ws(g, s, t, wm, im);
+                auto r2 = boost::custom_dijkstra_call(g, s, t, wm, im);
+                BOOST_REQUIRE(r1 && r2);
+                BOOST_CHECK(r1.value().first == dist[t]);
+                BOOST_CHECK(r2.value().first == dist[t]);
+                BOOST_CHECK(r1.value().second == p);
+                BOOST_CHECK(r2.value().second == p);
+              }
+        }
+    }
+}
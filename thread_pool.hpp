@@ -0,0 +1,140 @@
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include <algorithm>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// The pool of threads that run the submitted tasks.  The tasks run in
+// the order of submission, but they can finish in any order.  The
+// destructor runs the tasks that are still queued, and joins the
+// threads.
+class thread_pool
+{
+  // The threads.
+  std::vector<std::thread> m_threads;
+
+  // The queued tasks.
+  std::queue<std::function<void()>> m_tasks;
+
+  // The mutex of the tasks and the stop flag.
+  mutable std::mutex m_mutex;
+
+  // Notifies the threads about a task or the stop.
+  std::condition_variable m_cv;
+
+  // The threads should stop when the queue gets empty.
+  bool m_stop = false;
+
+  // The loop of a thread.
+  void
+  run()
+  {
+    while(true)
+      {
+        std::function<void()> task;
+
+        {
+          std::unique_lock<std::mutex> lock(m_mutex);
+          m_cv.wait(lock, [this]{return m_stop || !m_tasks.empty();});
+
+          if (m_tasks.empty())
+            return;
+
+          task = std::move(m_tasks.front());
+          m_tasks.pop();
+        }
+
+        task();
+      }
+  }
+
+public:
+  explicit thread_pool(unsigned n = std::thread::hardware_concurrency())
+  {
+    // There is at least one thread.
+    for (unsigned i = 0; i < std::max(n, 1u); ++i)
+      m_threads.emplace_back(&thread_pool::run, this);
+  }
+
+  ~thread_pool()
+  {
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_stop = true;
+    }
+
+    m_cv.notify_all();
+
+    for(auto &t: m_threads)
+      t.join();
+  }
+
+  thread_pool(const thread_pool &) = delete;
+
+  thread_pool &
+  operator=(const thread_pool &) = delete;
+
+  // The number of threads.
+  unsigned
+  size() const
+  {
+    return m_threads.size();
+  }
+
+  // The number of tasks queued, but not started yet.
+  std::size_t
+  pending() const
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_tasks.size();
+  }
+
+  // Submit the task, and return the future of its result.
+  template <typename F>
+  std::future<std::invoke_result_t<F>>
+  submit(F &&f)
+  {
+    using result_type = std::invoke_result_t<F>;
+
+    // The std::function has to be copyable, and so we share the
+    // packaged task.
+    auto pt = std::make_shared<std::packaged_task<result_type()>>
+      (std::forward<F>(f));
+    auto result = pt->get_future();
+
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_tasks.push([pt]{(*pt)();});
+    }
+
+    m_cv.notify_one();
+
+    return result;
+  }
+
+  // Call f(i) for every i in [0, n) in the threads, and return when
+  // all calls returned.
+  template <typename F>
+  void
+  parallel_for(std::size_t n, const F &f)
+  {
+    std::vector<std::future<void>> fs;
+
+    for (std::size_t i = 0; i < n; ++i)
+      fs.push_back(submit([&f, i]{f(i);}));
+
+    for (auto &fu: fs)
+      fu.get();
+  }
+};
+
+#endif // THREAD_POOL_HPP
@@ -1,6 +1,9 @@
 #include "traffic.hpp"
+#include "routing.hpp"
 
+#include <cassert>
 #include <list>
+#include <new>
 
 using namespace std;
 
@@ -12,8 +15,17 @@ traffic::traffic(double mcat, double mht, double mnu):
 
 traffic::~traffic()
 {
+  // Tear down the connections in one batch.
+  routing::batch b;
   for(auto c: cs)
-    delete c;
+    if (connection &conn = c->get_connection(); conn.is_established())
+      b.emplace_back(conn.detach(), routing::op_t::release);
+
+  bool status = routing::apply(m_mdl, b);
+  assert(status);
+
+  for(auto c: cs)
+    recycle(c);
 
   delete_clients();
 }
@@ -34,7 +46,7 @@ traffic::operator()(double t)
   // We are creating a client, but we ain't doing anything with the
   // pointer we get!  It's so, because it's up to the client to
   // register itself with the traffic.
-  new client(m_mht, m_mnu, *this);
+  new (m_pool.allocate()) client(m_mht, m_mnu, *this);
   schedule_next(t);
 }
 
@@ -45,16 +57,26 @@ traffic::schedule_next(double t)
   schedule(t + dt);
 }
 
+// The capacity served by the client.
+static int
+capacity(const client *cli)
+{
+  const connection &c = cli->get_connection();
+  return c.get_len() * c.get_ncu();
+}
+
 void
 traffic::insert(client *c)
 {
   cs.insert(c);
+  m_capacity += capacity(c);
 }
 
 void
 traffic::erase(client *c)
 {
   cs.erase(c);
+  m_capacity -= capacity(c);
 }
 
 void
@@ -66,18 +88,7 @@ traffic::delete_me_later(client *c)
 int
 traffic::capacity_served() const
 {
-  int capacity = 0;
-
-  // Iterate over all clients.
-  for(const client *cli: cs)
-    {
-      const connection &c = cli->get_connection();
-      int ncu = c.get_ncu();
-      int len = c.get_len();
-      capacity += len * ncu;
-    }
-
-  return capacity;
+  return m_capacity;
 }
 
 void
@@ -85,7 +96,14 @@ traffic::delete_clients()
 {
   while(!dl.empty())
     {
-      delete dl.front();
+      recycle(dl.front());
       dl.pop();
     }
 }
+
+void
+traffic::recycle(client *c)
+{
+  c->~client();
+  m_pool.deallocate(c);
+}
@@ -4,6 +4,7 @@
 #include "client.hpp"
 #include "graph.hpp"
 #include "module.hpp"
+#include "object_pool.hpp"
 #include "sim.hpp"
 
 #include <queue>
@@ -18,6 +19,10 @@ class traffic: public module<sim>
   // The queue of clients to delete later.
   std::queue<client *> dl;
 
+  // The pool of the clients.  The clients are created in the pool,
+  // and recycled when they are deleted.
+  object_pool<client> m_pool;
+
   // The ID counter.
   int idc;
 
@@ -33,6 +38,9 @@ class traffic: public module<sim>
   // Shortest distances.
   mutable std::map<npair, int> sd;
 
+  // The capacity served by the clients.
+  int m_capacity = 0;
+
 public:
   traffic(double mcat, double mht, double mnu);
 
@@ -44,25 +52,31 @@ public:
   // Return the number of clients.
   int nr_clients() const;
 
-  // Insert the client to the traffic.
+  // Insert the client to the traffic.  The connection of the client
+  // has to be established.
   void insert(client *);
 
-  // Remote the client from the traffic.
+  // Remote the client from the traffic.  The connection of the
+  // client has to be still established.
   void erase(client *);
 
   // Delete this client later.
   void delete_me_later(client *);
 
-  // Calculate the capacity currently served, which is defined as
+  // The capacity currently served, which is defined as
   // \sum_{i = connections} ncu_i * sp_i, where ncu_i is the number of
   // units of connection i, and sp_i is the length of the shortest
-  // path between end nodes of connection i.
+  // path between end nodes of connection i.  It's updated as the
+  // clients are inserted and erased.
   int
   capacity_served() const;
 
 private:
   void schedule_next(double);
   void delete_clients();
+
+  // Destroy the client, and recycle its memory.
+  void recycle(client *);
 };
 
 #endif /* TRAFFIC_HPP */
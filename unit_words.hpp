@@ -0,0 +1,56 @@
+#ifndef UNIT_WORDS_HPP
+#define UNIT_WORDS_HPP
+
+#include "units.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+// The bitmaps of the units, which are the rows of the occupancy
+// matrix and of the reservation store.  Bit u of the bitmap is bit u
+// % unit_bits of word u / unit_bits.
+
+// The word of a bitmap.
+using unit_word = std::uint64_t;
+
+// The number of bits of a word.
+constexpr unsigned unit_bits = 8 * sizeof(unit_word);
+
+// The bits of the units [a, b) in word w.
+inline unit_word
+unit_mask(unsigned a, unsigned b, std::size_t w)
+{
+  unsigned lo = std::max<std::size_t>(a, w * unit_bits) - w * unit_bits;
+  unsigned hi = std::min<std::size_t>(b, (w + 1) * unit_bits) -
+    w * unit_bits;
+
+  if (lo >= hi)
+    return 0;
+
+  unit_word m = ~unit_word(0) << lo;
+
+  return hi < unit_bits ? m & ~(~unit_word(0) << hi) : m;
+}
+
+// Call f(w, m) for the words w of the units of cu, where m is the
+// mask of the units in word w.
+template <typename F>
+void
+for_each_word(const CU &cu, F f)
+{
+  for (std::size_t w = cu.min() / unit_bits; w * unit_bits < cu.max(); ++w)
+    f(w, unit_mask(cu.min(), cu.max(), w));
+}
+
+// Call f(w, m) for the words of the units of the fragments of su.
+// The row of the SU of an edge is initialized this way.
+template <typename F>
+void
+for_each_word(const SU &su, F f)
+{
+  for(const auto &cu: su)
+    for_each_word(cu, f);
+}
+
+#endif // UNIT_WORDS_HPP
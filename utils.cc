@@ -57,6 +57,20 @@ vertex_in_path(const graph &g, const path &p, vertex v)
   return false;
 }
 
+vector<edge>
+index_edges(graph &g)
+{
+  vector<edge> result;
+
+  for (const auto &e: boost::make_iterator_range(edges(g)))
+    {
+      boost::put(boost::edge_index, g, e, result.size());
+      result.push_back(e);
+    }
+
+  return result;
+}
+
 void
 calc_sp_stats(const graph &g, dbl_acc &hop_acc, dbl_acc &len_acc)
 {
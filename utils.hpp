@@ -271,9 +271,29 @@ calculate_utilization(const G &g)
   return ba::mean(load_acc);
 }
 
+template<typename G>
+double
+calculate_frags(const G &g)
+{
+  ba::accumulator_set<double, ba::stats<ba::tag::mean> > frags;
+
+  typename G::edge_iterator ei, ee;
+  for (tie(ei, ee) = edges(g); ei != ee; ++ei)
+    frags(boost::get(boost::edge_su, g, *ei).size());
+
+  return ba::mean(frags);
+}
+
 bool
 vertex_in_path(const graph &g, const path &p, vertex v);
 
+/**
+ * Set the edge_index property of the edges in the order of iteration,
+ * and return the edges indexed with it.
+ */
+std::vector<edge>
+index_edges(graph &g);
+
 /**
  * Sets the units property on edges.
  */
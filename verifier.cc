@@ -0,0 +1,73 @@
+#include "verifier.hpp"
+
+#include <iostream>
+
+using namespace std;
+
+verifier::verifier(double rate, unsigned threads):
+  m_sample(rate), m_max_pending(16 * threads), m_runs(0), m_fails(0),
+  m_pool(threads)
+{
+}
+
+bool
+verifier::sample()
+{
+  return m_sample(m_rne);
+}
+
+void
+verifier::report(const string &what)
+{
+  ++m_fails;
+  lock_guard<mutex> lock(m_mutex);
+  cerr << "verification failed: " << what << endl;
+}
+
+bool
+verifier::try_reserve()
+{
+  if (m_pool.pending() >= m_max_pending)
+    {
+      ++m_dropped;
+      return false;
+    }
+
+  return true;
+}
+
+void
+verifier::done()
+{
+  {
+    lock_guard<mutex> lock(m_done_mutex);
+    ++m_done;
+  }
+
+  m_done_cv.notify_all();
+}
+
+void
+verifier::wait()
+{
+  unique_lock<mutex> lock(m_done_mutex);
+  m_done_cv.wait(lock, [this]{return m_done == m_submitted;});
+}
+
+unsigned long
+verifier::runs() const
+{
+  return m_runs;
+}
+
+unsigned long
+verifier::fails() const
+{
+  return m_fails;
+}
+
+unsigned long
+verifier::dropped() const
+{
+  return m_dropped;
+}
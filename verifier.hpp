@@ -0,0 +1,116 @@
+#ifndef VERIFIER_HPP
+#define VERIFIER_HPP
+
+#include "thread_pool.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <random>
+#include <string>
+#include <utility>
+
+// The verifier runs the checks of a sampled fraction of the searches
+// in the background threads.  A check gets the copies of the data it
+// needs, so that the simulation thread doesn't wait.  The failures
+// are reported to the standard error.
+class verifier
+{
+  // The random number engine of the sampling.
+  std::default_random_engine m_rne;
+
+  // The sampling distribution.
+  std::bernoulli_distribution m_sample;
+
+  // The maximal number of checks queued.  Above that, the samples are
+  // dropped, so that the checks don't pile up.
+  std::size_t m_max_pending;
+
+  // The number of checks run.
+  std::atomic<unsigned long> m_runs;
+
+  // The number of checks failed.
+  std::atomic<unsigned long> m_fails;
+
+  // The number of samples dropped.
+  unsigned long m_dropped = 0;
+
+  // The number of checks submitted.
+  unsigned long m_submitted = 0;
+
+  // The number of checks finished, its mutex, and the condition
+  // signalled when a check finishes.
+  unsigned long m_done = 0;
+  std::mutex m_done_mutex;
+  std::condition_variable m_done_cv;
+
+  // The mutex of the reports.
+  std::mutex m_mutex;
+
+  // The threads that run the checks.  It's the last member, so that
+  // the threads are joined before the other members are destroyed.
+  thread_pool m_pool;
+
+  // Report the failure of a check.
+  void
+  report(const std::string &what);
+
+  // Report that a check finished.
+  void
+  done();
+
+public:
+  // Sample searches at the given rate, and check them with the given
+  // number of threads.
+  verifier(double rate, unsigned threads);
+
+  // True if a search should be checked.
+  bool
+  sample();
+
+  // True if a check can be submitted.  Otherwise the sample is
+  // dropped, so that the caller doesn't copy the data of the check
+  // in vain.
+  bool
+  try_reserve();
+
+  // Submit the check, which returns true if the search is correct.
+  // The what describes the search.  It's called after try_reserve
+  // returned true.
+  template <typename F>
+  void
+  submit(F &&check, std::string what);
+
+  // Wait for the submitted checks to finish.
+  void
+  wait();
+
+  // The number of checks run.
+  unsigned long
+  runs() const;
+
+  // The number of checks failed.
+  unsigned long
+  fails() const;
+
+  // The number of samples dropped.
+  unsigned long
+  dropped() const;
+};
+
+template <typename F>
+void
+verifier::submit(F &&check, std::string what)
+{
+  ++m_submitted;
+  m_pool.submit([this, check = std::forward<F>(check),
+                 what = std::move(what)]() mutable
+                {
+                  ++m_runs;
+                  if (!check())
+                    report(what);
+                  done();
+                });
+}
+
+#endif // VERIFIER_HPP
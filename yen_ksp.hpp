@@ -30,10 +30,13 @@
 #include <list>
 #include <optional>
 #include <set>
+#include <type_traits>
 #include <utility>
+#include <vector>
 
 #include <boost/graph/dijkstra_shortest_paths.hpp>
 #include <boost/graph/filtered_graph.hpp>
+#include <boost/range/iterator_range.hpp>
 
 #include "custom_dijkstra_call.hpp"
 
@@ -51,12 +54,49 @@ namespace boost {
   template <typename W, typename G>
   using Result = std::pair<W, Path<G>>;
 
-  template <typename Graph, typename WeightMap, typename IndexMap>
+  // =====================================================================
+  // The root of the spur paths that allows any spur path.  A root is
+  // cleared at the beginning of an iteration, the edges of the root
+  // path are pushed back to it, and the spur paths are searched only
+  // when it's viable.
+  // =====================================================================
+  struct yen_any_root
+  {
+    void
+    clear()
+    {
+    }
+
+    template <typename E>
+    void
+    push_back(const E &)
+    {
+    }
+
+    bool
+    viable() const
+    {
+      return true;
+    }
+  };
+
+  // =====================================================================
+  // The iteration of the Yen algorithm, which finds the next shortest
+  // path with the search.  The search is called as search(g, s, t),
+  // where g is the graph or its filtered graph, and it returns the
+  // optional shortest path from s to t with its cost.  The spur paths
+  // are not searched for the root paths that are not viable.
+  // =====================================================================
+  template <typename Graph, typename WeightMap, typename Search,
+            typename Root = yen_any_root>
   bool
-  yen_ksp(const Graph& g, Vertex<Graph> s, Vertex<Graph> t,
-          WeightMap wm, IndexMap im,
-          std::list<Result<typename WeightMap::value_type, Graph>> &A,
-          std::set<Result<typename WeightMap::value_type, Graph>> &B)
+  yen_ksp_search(const Graph& g, Vertex<Graph> s, Vertex<Graph> t,
+                 WeightMap wm,
+                 std::list<Result<typename WeightMap::value_type,
+                                  Graph>> &A,
+                 std::set<Result<typename WeightMap::value_type,
+                                 Graph>> &B,
+                 Search search, Root &&root = Root())
   {
     using vs_type = std::set<Vertex<Graph>>;
     using es_type = std::set<Edge<Graph>>;
@@ -71,8 +111,10 @@ namespace boost {
     if (A.empty())
       {
         assert(B.empty());
+        root.clear();
         // Try to find the (optional) shortest path.
-        ksp = custom_dijkstra_call(g, s, t, wm, im);
+        if (root.viable())
+          ksp = search(g, s, t);
       }
     else
       {
@@ -98,6 +140,7 @@ namespace boost {
         kr_type rr;
         // The root path.
         const Path<Graph> &rp = rr.second;
+        root.clear();
 
         // Use the previous shortest path to get tentative paths.  We
         // can go ahead with the loop without checking any condition
@@ -137,8 +180,9 @@ namespace boost {
               }
 
             // Optional spur result.
-            std::optional<kr_type>
-              osr = custom_dijkstra_call(fg, sv, t, wm, im);
+            std::optional<kr_type> osr;
+            if (root.viable())
+              osr = search(fg, sv, t);
 
             if (osr)
               {
@@ -165,6 +209,7 @@ namespace boost {
             // Add the edge to the back of the root result.
             rr.first += get(wm, edge);
             rr.second.push_back(edge);
+            root.push_back(edge);
           }
 
         // Take the shortest tentative path and make it the next
@@ -181,7 +226,432 @@ namespace boost {
           
     return bool(ksp);
   }
+
+  template <typename Graph, typename WeightMap, typename IndexMap>
+  bool
+  yen_ksp(const Graph& g, Vertex<Graph> s, Vertex<Graph> t,
+          WeightMap wm, IndexMap im,
+          std::list<Result<typename WeightMap::value_type, Graph>> &A,
+          std::set<Result<typename WeightMap::value_type, Graph>> &B)
+  {
+    return yen_ksp_search(g, s, t, wm, A, B,
+                          [wm, im](const auto &fg, auto u, auto v)
+                          {
+                            return custom_dijkstra_call(fg, u, v, wm, im);
+                          });
+  }
+
+  // =====================================================================
+  // The variant that searches with the workspace, which is reused by
+  // the searches, and can be reused by the calls.
+  // =====================================================================
+  template <typename Graph, typename WeightMap, typename IndexMap>
+  bool
+  yen_ksp(const Graph& g, Vertex<Graph> s, Vertex<Graph> t,
+          WeightMap wm, IndexMap im,
+          std::list<Result<typename WeightMap::value_type, Graph>> &A,
+          std::set<Result<typename WeightMap::value_type, Graph>> &B,
+          dijkstra_workspace<Graph, typename WeightMap::value_type> &ws)
+  {
+    return yen_ksp_search(g, s, t, wm, A, B,
+                          [wm, im, &ws](const auto &fg, auto u, auto v)
+                          {
+                            return ws(fg, u, v, wm, im);
+                          });
+  }
   
+  // The edge predicate of the graph of the spur paths, which keeps the
+  // edges allowed by the root.
+  template <typename Root>
+  struct yen_root_pred
+  {
+    const Root *m_root = nullptr;
+
+    yen_root_pred() = default;
+
+    yen_root_pred(const Root &root): m_root(&root)
+    {
+    }
+
+    template <typename E>
+    bool
+    operator()(const E &e) const
+    {
+      return (*m_root)(e);
+    }
+  };
+
+  // =====================================================================
+  // The variant that searches with the workspace the spur paths that
+  // the root allows.  The root has to be viable for a spur path to be
+  // searched, and the root as the edge predicate allows the edges of
+  // the spur path.  Both conditions are necessary for a path to be
+  // feasible.  If a root is not viable, then no path that begins
+  // with the root path is feasible, and so the first feasible path
+  // found is the shortest feasible path, though the infeasible paths
+  // are found in a different order.
+  // =====================================================================
+  template <typename Graph, typename WeightMap, typename IndexMap,
+            typename Root>
+  bool
+  yen_ksp(const Graph& g, Vertex<Graph> s, Vertex<Graph> t,
+          WeightMap wm, IndexMap im,
+          std::list<Result<typename WeightMap::value_type, Graph>> &A,
+          std::set<Result<typename WeightMap::value_type, Graph>> &B,
+          dijkstra_workspace<Graph, typename WeightMap::value_type> &ws,
+          Root &root)
+  {
+    return yen_ksp_search(g, s, t, wm, A, B,
+                          [wm, im, &ws, &root](const auto &fg, auto u,
+                                               auto v)
+                          {
+                            using fg_type = std::decay_t<decltype(fg)>;
+                            filtered_graph<fg_type, yen_root_pred<Root>>
+                              rfg(fg, yen_root_pred<Root>(root));
+                            return ws(rfg, u, v, wm, im);
+                          }, root);
+  }
+
+  // =====================================================================
+  // The variant that completes the spur paths with the reverse shortest
+  // path tree rooted at t, computed once per query.  The spur path is
+  // the shortest one that leaves the spur vertex along an allowed
+  // deviation edge, and then follows the tree to t.  Such a path is
+  // optimal if the tree path is not blocked by the excluded vertexes
+  // or edges, because the tree distance is a lower bound on the
+  // distance in the filtered graph.  Otherwise the Dijkstra search is
+  // run with the workspace.
+  // =====================================================================
+
+  // True if the vertex is not excluded from the graph.
+  template <typename Graph>
+  bool
+  is_allowed(const Graph &, Vertex<Graph>)
+  {
+    return true;
+  }
+
+  template <typename Graph, typename EP, typename VP>
+  bool
+  is_allowed(const filtered_graph<Graph, EP, VP> &fg, Vertex<Graph> v)
+  {
+    return fg.m_vertex_pred(v);
+  }
+
+  // True if the edge is not excluded from the graph.
+  template <typename Graph>
+  bool
+  is_allowed(const Graph &, Edge<Graph>)
+  {
+    return true;
+  }
+
+  template <typename Graph, typename EP, typename VP>
+  bool
+  is_allowed(const filtered_graph<Graph, EP, VP> &fg, Edge<Graph> e)
+  {
+    return fg.m_edge_pred(e);
+  }
+
+  // The visitor that records the predecessor edges in the tree of
+  // the paths from the root.
+  template <typename Graph, typename IndexMap>
+  struct tree_visitor: base_visitor<tree_visitor<Graph, IndexMap>>
+  {
+    using event_filter = on_edge_relaxed;
+    std::vector<Edge<Graph>> &m_pred;
+    std::vector<bool> &m_has;
+    IndexMap m_im;
+    tree_visitor(std::vector<Edge<Graph>> &pred, std::vector<bool> &has,
+                 IndexMap im): m_pred(pred), m_has(has), m_im(im) {}
+    void operator()(Edge<Graph> e, const Graph &g)
+    {
+      auto i = get(m_im, target(e, g));
+      m_pred[i] = e;
+      m_has[i] = true;
+    }
+  };
+
+  // Compute the shortest path tree rooted at t: the distances to t,
+  // and the next edges towards t, oriented from the vertexes.  The
+  // vertexes that don't reach t, and t itself, have no next edge.
+  template <typename Graph, typename WeightMap, typename IndexMap>
+  void
+  reverse_tree(const Graph &g, Vertex<Graph> t, WeightMap wm, IndexMap im,
+               std::vector<typename WeightMap::value_type> &dist,
+               std::vector<std::optional<Edge<Graph>>> &next)
+  {
+    // The predecessor edges in the tree of the paths from t.  The
+    // graph is undirected, so they are the paths to t.
+    std::vector<Edge<Graph>> pred(num_vertices(g));
+    std::vector<bool> has_pred(num_vertices(g));
+
+    using visitor = tree_visitor<Graph, IndexMap>;
+
+    dijkstra_shortest_paths
+      (g, t, weight_map(wm).vertex_index_map(im).
+       distance_map(make_iterator_property_map(dist.begin(), im)).
+       visitor(make_dijkstra_visitor(visitor(pred, has_pred, im))));
+
+    // Orient the tree edges from the vertex towards t.
+    for (auto v: make_iterator_range(vertices(g)))
+      if (auto i = get(im, v); has_pred[i])
+        for (auto e: make_iterator_range(out_edges(v, g)))
+          if (e == pred[i])
+            {
+              next[i] = e;
+              break;
+            }
+  }
+
+  template <typename Graph, typename WeightMap, typename IndexMap>
+  class yen_tree
+  {
+    using weight_type = typename WeightMap::value_type;
+    using kr_type = Result<weight_type, Graph>;
+
+    const Graph &m_g;
+    WeightMap m_wm;
+    IndexMap m_im;
+
+    // The root of the tree.
+    Vertex<Graph> m_t;
+
+    // The distances to t.
+    std::vector<weight_type> m_dist;
+
+    // The next edge towards t, oriented from the vertex.
+    std::vector<std::optional<Edge<Graph>>> m_next;
+
+    // The workspace of the fallback searches.
+    dijkstra_workspace<Graph, weight_type> m_ws;
+
+  public:
+    // The number of spur paths completed with the tree.
+    std::size_t m_saved = 0;
+
+    // The number of the fallback Dijkstra searches.
+    std::size_t m_calls = 0;
+
+    yen_tree(const Graph &g, Vertex<Graph> t, WeightMap wm, IndexMap im):
+      m_g(g), m_wm(wm), m_im(im), m_t(t), m_dist(num_vertices(g)),
+      m_next(num_vertices(g)), m_ws(num_vertices(g))
+    {
+      reverse_tree(g, t, wm, im, m_dist, m_next);
+    }
+
+    // Search for the shortest path from s to t in graph g, which can
+    // be a filtered graph of Graph.
+    template <typename G>
+    std::optional<kr_type>
+    operator()(const G &g, Vertex<Graph> s, Vertex<Graph> t)
+    {
+      assert(t == m_t);
+
+      // The lower bound over the deviation edges.
+      std::optional<weight_type> lb;
+      for (auto e: make_iterator_range(out_edges(s, g)))
+        if (auto w = target(e, g); w == t || m_next[get(m_im, w)])
+          {
+            weight_type c = get(m_wm, e) + m_dist[get(m_im, w)];
+            if (!lb || c < lb.value())
+              lb = c;
+          }
+
+      if (lb)
+        // A deviation edge of the lower bound whose tree path is not
+        // blocked yields the shortest path.
+        for (auto e: make_iterator_range(out_edges(s, g)))
+          if (auto w = target(e, g); w == t || m_next[get(m_im, w)])
+            if (get(m_wm, e) + m_dist[get(m_im, w)] == lb.value())
+              if (auto r = tree_path(g, s, e))
+                {
+                  ++m_saved;
+                  return r;
+                }
+
+      ++m_calls;
+      return m_ws(g, s, t, m_wm, m_im);
+    }
+
+  private:
+    // The path from s along edge e, and then along the tree, unless
+    // the tree path is blocked.
+    template <typename G>
+    std::optional<kr_type>
+    tree_path(const G &g, Vertex<Graph> s, Edge<Graph> e)
+    {
+      kr_type r;
+      r.first = get(m_wm, e);
+      r.second.push_back(e);
+
+      for (auto v = target(e, g); v != m_t;)
+        {
+          const auto &ne = m_next[get(m_im, v)].value();
+          v = target(ne, m_g);
+
+          if (v == s || !is_allowed(g, v) || !is_allowed(g, ne))
+            return std::nullopt;
+
+          r.first += get(m_wm, ne);
+          r.second.push_back(ne);
+        }
+
+      return r;
+    }
+  };
+
+  template <typename Graph, typename WeightMap, typename IndexMap>
+  bool
+  yen_ksp(const Graph& g, Vertex<Graph> s, Vertex<Graph> t,
+          WeightMap wm, IndexMap,
+          std::list<Result<typename WeightMap::value_type, Graph>> &A,
+          std::set<Result<typename WeightMap::value_type, Graph>> &B,
+          yen_tree<Graph, WeightMap, IndexMap> &tree)
+  {
+    return yen_ksp_search(g, s, t, wm, A, B,
+                          [&tree](const auto &fg, auto u, auto v)
+                          {
+                            return tree(fg, u, v);
+                          });
+  }
+
+  // =====================================================================
+  // The spur path of the i-th spur vertex of the previous shortest path
+  // psp, i.e., the tentative path that deviates from psp at the source
+  // of the i-th edge of psp.  The root path and the excluded edges and
+  // vertexes are built for this spur only, and so the spurs can be
+  // computed independently.
+  // =====================================================================
+  template <typename Graph, typename WeightMap, typename IndexMap>
+  std::optional<Result<typename WeightMap::value_type, Graph>>
+  yen_spur(const Graph& g, Vertex<Graph> t, WeightMap wm, IndexMap im,
+           const std::list<Result<typename WeightMap::value_type,
+                                  Graph>> &A,
+           const std::vector<Edge<Graph>> &psp, std::size_t i)
+  {
+    using vs_type = std::set<Vertex<Graph>>;
+    using es_type = std::set<Edge<Graph>>;
+    using kr_type = Result<typename WeightMap::value_type, Graph>;
+    using fg_type = filtered_graph<Graph,
+                                   is_not_in_subset<es_type>,
+                                   is_not_in_subset<vs_type>>;
+
+    // The spur vertex.
+    const Vertex<Graph> &sv = source(psp[i], g);
+
+    // The root result: the first i edges of psp.  The vertexes of
+    // the root path, but the spur vertex, are excluded.
+    kr_type rr;
+    vs_type exv;
+    for (std::size_t j = 0; j < i; ++j)
+      {
+        exv.insert(source(psp[j], g));
+        rr.first += get(wm, psp[j]);
+        rr.second.push_back(psp[j]);
+      }
+
+    // The root path.
+    const Path<Graph> &rp = rr.second;
+
+    // The excluded edges: the next edges of the previous shortest
+    // paths that begin with the complete root path.
+    es_type exe;
+    for(const auto &jr: A)
+      {
+        // The j-th shortest path.
+        const Path<Graph> &jp = jr.second;
+
+        typename Path<Graph>::const_iterator jpi = jp.begin();
+        typename Path<Graph>::const_iterator rpi = rp.begin();
+
+        while(jpi != jp.end() && rpi != rp.end() && *jpi == *rpi)
+          ++jpi, ++rpi;
+
+        if (jpi != jp.end() && rpi == rp.end())
+          exe.insert(*jpi);
+      }
+
+    // The edge predicate.
+    is_not_in_subset<es_type> ep(exe);
+    // The vertex predicate.
+    is_not_in_subset<vs_type> vp(exv);
+    // The filtered graph.
+    fg_type fg(g, ep, vp);
+
+    // Optional spur result.
+    std::optional<kr_type> osr = custom_dijkstra_call(fg, sv, t, wm, im);
+
+    if (osr)
+      {
+        osr.value().first += rr.first;
+        osr.value().second.insert(osr.value().second.begin(), rp.begin(),
+                                  rp.end());
+      }
+
+    return osr;
+  }
+
+  // =====================================================================
+  // The parallel variant: the spur paths of an iteration are computed
+  // concurrently.  The pf is called as pf(n, f), and it should call
+  // f(i) for every i in [0, n), possibly concurrently, and return when
+  // all calls returned.  The spur paths are merged into B in the order
+  // of the spur vertexes, and so the results are the same as of the
+  // serial version.
+  // =====================================================================
+  template <typename Graph, typename WeightMap, typename IndexMap,
+            typename ParallelFor>
+  bool
+  yen_ksp(const Graph& g, Vertex<Graph> s, Vertex<Graph> t,
+          WeightMap wm, IndexMap im,
+          std::list<Result<typename WeightMap::value_type, Graph>> &A,
+          std::set<Result<typename WeightMap::value_type, Graph>> &B,
+          ParallelFor pf)
+  {
+    using kr_type = Result<typename WeightMap::value_type, Graph>;
+
+    std::optional<kr_type> ksp;
+
+    // If A is empty, then we're looking for the first shortest path.
+    if (A.empty())
+      {
+        assert(B.empty());
+        ksp = custom_dijkstra_call(g, s, t, wm, im);
+      }
+    else
+      {
+        // The previous shortest path.
+        const auto &lsp = A.back().second;
+        std::vector<Edge<Graph>> psp(lsp.begin(), lsp.end());
+
+        // The spur results, one per spur vertex.
+        std::vector<std::optional<kr_type>> srs(psp.size());
+
+        pf(psp.size(), [&](std::size_t i)
+                       {
+                         srs[i] = yen_spur(g, t, wm, im, A, psp, i);
+                       });
+
+        for (auto &sr: srs)
+          if (sr)
+            B.insert(std::move(sr.value()));
+
+        // Take the shortest tentative path and make it the next
+        // shortest path.
+        if (!B.empty())
+          {
+            ksp = *B.begin();
+            B.erase(B.begin());
+          }
+      }
+
+    if (ksp)
+      A.push_back(std::move(ksp.value()));
+
+    return bool(ksp);
+  }
+
   template <typename Graph, typename WeightMap, typename IndexMap>
   std::list<std::pair<typename WeightMap::value_type,
                       std::list<typename Graph::edge_descriptor>>>
@@ -204,7 +674,7 @@ namespace boost {
         std::set<kr_type> B;
 
         // In each iteration we produce the k-th shortest path.
-        for (int k = 1; !K || k <= K.value(); ++k)
+        for (unsigned k = 1; !K || k <= K.value(); ++k)
           if (!yen_ksp(g, s, t, wm, im, A, B))
             // We break the loop if no path was found.
             break;